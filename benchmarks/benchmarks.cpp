@@ -0,0 +1,329 @@
+#include "Serialization.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+
+using std::chrono::high_resolution_clock;
+using Serialization::Serializer;
+using Serialization::Deserializer;
+
+// Same layout as a float but opted out of bulk copies, measures the element by element path
+struct ElementWise
+{
+    float value;
+};
+
+namespace Serialization
+{
+    template <>
+    struct is_bulk_copyable<ElementWise> : std::false_type {};
+}
+
+// Runs fn `iterations` times and prints the throughput over `bytes` per iteration
+template <typename Fn>
+void measure(const std::string &name, size_t iterations, size_t bytes, Fn fn)
+{
+    auto start = high_resolution_clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        fn();
+    std::chrono::duration<double> elapsed = high_resolution_clock::now() - start;
+    double perIteration = elapsed.count() / iterations;
+    std::cout << std::left << std::setw(36) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << perIteration * 1e6 << " us"
+              << std::setw(12) << std::setprecision(0) << bytes / perIteration / (1024 * 1024) << " MB/s" << std::endl;
+}
+
+void benchPodVectorRead()
+{
+    const size_t count = 1 << 20;
+    const size_t iterations = 50;
+
+    std::vector<float> floats(count);
+    std::vector<ElementWise> elements(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+        floats[k] = k * 0.5f;
+        elements[k].value = k * 0.5f;
+    }
+
+    Serializer bulk;
+    bulk.write(floats);
+    Serializer elementWise;
+    elementWise.write(elements);
+
+    measure("read vector<float> bulk", iterations, bulk.dataLength(), [&]
+            {
+                std::vector<float> out;
+                Deserializer d(bulk.data(), bulk.dataLength());
+                d.read(out);
+            });
+    measure("read vector<float> element-wise", iterations, elementWise.dataLength(), [&]
+            {
+                std::vector<ElementWise> out;
+                Deserializer d(elementWise.data(), elementWise.dataLength());
+                d.read(out);
+            });
+    measure("write vector<float> bulk", iterations, bulk.dataLength(), [&]
+            {
+                Serializer s;
+                s.write(floats);
+            });
+    measure("write vector<float> element-wise", iterations, elementWise.dataLength(), [&]
+            {
+                Serializer s;
+                s.write(elements);
+            });
+}
+
+void benchByteOrder()
+{
+    const size_t count = 1 << 20;
+    const size_t iterations = 50;
+
+    Serialization::WireFormat swapped;
+    swapped.byteOrder = Serialization::hostIsLittleEndian() ? Serialization::ByteOrder::Big : Serialization::ByteOrder::Little;
+
+    std::vector<uint32_t> ints(count);
+    for (size_t k = 0; k < count; ++k)
+        ints[k] = static_cast<uint32_t>(k * 2654435761u);
+
+    Serializer native;
+    native.write(ints);
+    Serializer swappedSerializer;
+    swappedSerializer.setFormat(swapped);
+    swappedSerializer.write(ints);
+
+    measure("write vector<uint32_t> native", iterations, native.dataLength(), [&]
+            {
+                Serializer s;
+                s.write(ints);
+            });
+    measure("write vector<uint32_t> swapped", iterations, swappedSerializer.dataLength(), [&]
+            {
+                Serializer s;
+                s.setFormat(swapped);
+                s.write(ints);
+            });
+    measure("read vector<uint32_t> swapped", iterations, swappedSerializer.dataLength(), [&]
+            {
+                std::vector<uint32_t> out;
+                Deserializer d(swappedSerializer.data(), swappedSerializer.dataLength());
+                d.setFormat(swapped);
+                d.read(out);
+            });
+}
+
+void benchCompression()
+{
+    const size_t iterations = 10;
+
+    std::vector<std::string> table;
+    for (size_t k = 0; k < (1 << 18); ++k)
+        table.push_back("frame-" + std::to_string(k % 1000) + "-label");
+    Serializer plain;
+    plain.write(table);
+
+    for (unsigned threads : {1u, 0u})
+    {
+        Serialization::CompressionOptions options;
+        options.threads = threads;
+        Serializer packed;
+        packed.writeCompressed(plain.data(), plain.dataLength(), options);
+        std::cout << "compressed " << plain.dataLength() << " -> " << packed.dataLength() << " bytes" << std::endl;
+
+        std::string suffix = threads == 1 ? " 1 thread" : " all threads";
+        measure("compress" + suffix, iterations, plain.dataLength(), [&]
+                {
+                    Serializer s;
+                    s.writeCompressed(plain.data(), plain.dataLength(), options);
+                });
+        measure("decompress" + suffix, iterations, plain.dataLength(), [&]
+                {
+                    Deserializer d(packed.data(), packed.dataLength());
+                    d.readCompressed(threads);
+                });
+    }
+}
+
+void benchChecksum()
+{
+    const size_t iterations = 200;
+
+    std::vector<uint8_t> frame(1024 * 1024);
+    for (size_t k = 0; k < frame.size(); ++k)
+        frame[k] = static_cast<uint8_t>(k * 2654435761u >> 11);
+
+    measure("write 1 MB frame", iterations, frame.size(), [&]
+            {
+                Serializer s;
+                s.write(frame);
+            });
+    measure("write 1 MB frame with checksum", iterations, frame.size(), [&]
+            {
+                Serializer s;
+                s.beginChecksum();
+                s.write(frame);
+                s.writeChecksum();
+            });
+    measure("crc32c 1 MB", iterations, frame.size(), [&]
+            {
+                volatile uint32_t crc = Serialization::crc32c(frame.data(), frame.size());
+                (void)crc;
+            });
+    measure("crc32c 1 MB portable", iterations, frame.size(), [&]
+            {
+                volatile uint32_t crc = Serialization::crc::updatePortable(~0u, frame.data(), frame.size());
+                (void)crc;
+            });
+}
+
+void benchReuseDecode()
+{
+    const size_t iterations = 20;
+
+    std::map<std::string, std::vector<std::string>> table;
+    for (size_t k = 0; k < (1 << 14); ++k)
+        table["key long enough to need a heap allocation " + std::to_string(k)] = {"value long enough to need a heap allocation", "v"};
+    Serializer s;
+    s.write(table);
+
+    measure("read map fresh", iterations, s.dataLength(), [&]
+            {
+                std::map<std::string, std::vector<std::string>> out;
+                Deserializer d(s.data(), s.dataLength());
+                d.read(out);
+            });
+    std::map<std::string, std::vector<std::string>> reused;
+    measure("read map reusing contents", iterations, s.dataLength(), [&]
+            {
+                Deserializer d(s.data(), s.dataLength());
+                d.setReuse(true);
+                d.read(reused);
+            });
+}
+
+void benchParallelWrite()
+{
+    const size_t iterations = 20;
+
+    std::vector<std::map<std::string, std::string>> rows(1 << 15);
+    for (size_t k = 0; k < rows.size(); ++k)
+        rows[k] = {{"id", std::to_string(k)}, {"name", "row name long enough to need a heap allocation"}};
+    size_t bytes = Serialization::serializedSize(rows);
+
+    measure("write vector<map> sequential", iterations, bytes, [&]
+            {
+                Serializer s;
+                s.write(rows);
+            });
+    measure("write vector<map> parallel", iterations, bytes, [&]
+            {
+                Serializer s;
+                s.setParallel(true);
+                s.write(rows);
+            });
+    Serializer reused;
+    reused.setParallel(true);
+    measure("write vector<map> parallel reused", iterations, bytes, [&]
+            {
+                reused.reset();
+                reused.write(rows);
+            });
+}
+
+void benchParallelRead()
+{
+    const size_t iterations = 20;
+
+    std::vector<std::map<std::string, std::string>> rows(1 << 15);
+    for (size_t k = 0; k < rows.size(); ++k)
+        rows[k] = {{"id", std::to_string(k)}, {"name", "row name long enough to need a heap allocation"}};
+    Serialization::WireFormat format;
+    format.chunkIndexThreshold = 4096;
+    Serializer s;
+    s.setFormat(format);
+    s.write(rows);
+
+    measure("read vector<map> sequential", iterations, s.dataLength(), [&]
+            {
+                Deserializer d(s.data(), s.dataLength());
+                d.setFormat(format);
+                d.read<std::vector<std::map<std::string, std::string>>>();
+            });
+    measure("read vector<map> parallel", iterations, s.dataLength(), [&]
+            {
+                Deserializer d(s.data(), s.dataLength());
+                d.setFormat(format);
+                d.setParallel(true);
+                d.read<std::vector<std::map<std::string, std::string>>>();
+            });
+
+    // Chunks decode into their own hash maps, whose nodes are then relinked into one
+    std::unordered_map<std::string, std::string> table;
+    for (size_t k = 0; k < (1 << 17); ++k)
+        table["key " + std::to_string(k)] = "value long enough to need a heap allocation";
+    Serializer t;
+    t.setFormat(format);
+    t.write(table);
+
+    measure("read unordered_map sequential", iterations, t.dataLength(), [&]
+            {
+                Deserializer d(t.data(), t.dataLength());
+                d.setFormat(format);
+                d.read<std::unordered_map<std::string, std::string>>();
+            });
+    measure("read unordered_map parallel", iterations, t.dataLength(), [&]
+            {
+                Deserializer d(t.data(), t.dataLength());
+                d.setFormat(format);
+                d.setParallel(true);
+                d.read<std::unordered_map<std::string, std::string>>();
+            });
+}
+
+#if defined(SERIALIZATION_HAS_PMR)
+void benchArenaDecode()
+{
+    const size_t iterations = 20;
+
+    std::vector<std::string> names;
+    for (size_t k = 0; k < (1 << 16); ++k)
+        names.push_back("name long enough to need a heap allocation " + std::to_string(k));
+    Serializer s;
+    s.write(names);
+
+    measure("read vector<string> heap", iterations, s.dataLength(), [&]
+            {
+                std::vector<std::string> out;
+                Deserializer d(s.data(), s.dataLength());
+                d.read(out);
+            });
+    std::vector<uint8_t> arenaStorage(2 * s.dataLength());
+    measure("read pmr vector<string> arena", iterations, s.dataLength(), [&]
+            {
+                std::pmr::monotonic_buffer_resource arena(arenaStorage.data(), arenaStorage.size());
+                Deserializer d(s.data(), s.dataLength());
+                d.setMemoryResource(&arena);
+                auto out = d.make<std::pmr::vector<std::pmr::string>>();
+                d.read(out);
+            });
+}
+#endif
+
+int main()
+{
+    benchPodVectorRead();
+    benchByteOrder();
+    benchCompression();
+    benchChecksum();
+    benchReuseDecode();
+    benchParallelWrite();
+    benchParallelRead();
+#if defined(SERIALIZATION_HAS_PMR)
+    benchArenaDecode();
+#endif
+    return 0;
+}
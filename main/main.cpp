@@ -49,10 +49,9 @@ namespace Serialization
     template<>
     inline void Deserializer::read<time_point<high_resolution_clock>>(time_point<high_resolution_clock>& t)
     {
-        long long epoch_time;
+        high_resolution_clock::duration epoch_time;
         read(epoch_time);
-        std::chrono::nanoseconds epoch_time_ns(epoch_time);
-        t = time_point<high_resolution_clock>(epoch_time_ns);
+        t = time_point<high_resolution_clock>(epoch_time);
     }
 
     template<>
@@ -97,6 +96,21 @@ int main(int argc, const char** argv)
     serializer.write(dataMap);
     std::cout << "Total Serialized data size: " << serializer.dataLength() << std::endl;
 
+    // Same data with varint lengths and integers
+    Serializer compactSerializer;
+    compactSerializer.setFormat(Serialization::WireFormat::compact());
+    compactSerializer.write(now);
+    compactSerializer.write(listOfStr);
+    compactSerializer.write(dataMap);
+    std::cout << "Compact Serialized data size: " << compactSerializer.dataLength() << std::endl;
+
+    // Whole message compressed, the default threshold would store this small message as is
+    Serialization::CompressionOptions compression;
+    compression.threshold = 0;
+    Serializer compressedSerializer;
+    compressedSerializer.writeCompressed(serializer.data(), serializer.dataLength(), compression);
+    std::cout << "Compressed Serialized data size: " << compressedSerializer.dataLength() << std::endl;
+
     // Deserializing data
     time_point<high_resolution_clock> nowDe;
     Strings listOfStrDe;
@@ -106,6 +120,20 @@ int main(int argc, const char** argv)
     deserializer.read(listOfStrDe);
     deserializer.read(dataMapDe);
 
+#if defined(SERIALIZATION_HAS_PMR)
+    // The same strings decoded into one arena, released in a single step at scope exit
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        Deserializer arenaDeserializer(serializer.data(), serializer.dataLength());
+        arenaDeserializer.setMemoryResource(&arena);
+        time_point<high_resolution_clock> arenaNow;
+        auto arenaStrings = arenaDeserializer.make<std::pmr::vector<std::pmr::string>>();
+        arenaDeserializer.read(arenaNow);
+        arenaDeserializer.read(arenaStrings);
+        std::cout << "Arena decoded strings: " << arenaStrings.size() << std::endl;
+    }
+#endif
+
     // Cpompairing the deserialized data to original data
     bool isNowSame = now == nowDe;
     std::cout << "isNowSame: " << std::boolalpha << isNowSame << std::endl;
@@ -0,0 +1,212 @@
+#ifndef _BYTE_ORDER_HPP_
+#define _BYTE_ORDER_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#include "WireFormat.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SERIALIZATION_X86_SIMD 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SERIALIZATION_NEON 1
+#endif
+
+namespace Serialization
+{
+  // =====================
+  // Byte order helpers
+  // =====================
+  inline bool hostIsLittleEndian()
+  {
+#if defined(__BYTE_ORDER__)
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+#endif
+  }
+
+  // True when scalars must be byte swapped between host and wire
+  inline bool needsByteSwap(ByteOrder order)
+  {
+    return order != ByteOrder::Native && (order == ByteOrder::Little) != hostIsLittleEndian();
+  }
+
+  // Width T's bytes are reordered by between host and `order`, 0 when they are copied
+  // as is. Aggregates other than std::array cannot be reordered and throw.
+  template <typename T>
+  inline size_t swapWidth(ByteOrder order)
+  {
+    if (swap_width<T>::value == 1 || !needsByteSwap(order))
+      return 0;
+    if (swap_width<T>::value == 0)
+      throw std::runtime_error("Byte order conversion needs scalar or std::array values");
+    return swap_width<T>::value;
+  }
+
+  inline uint16_t byteSwap16(uint16_t v)
+  {
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+  }
+
+  inline uint32_t byteSwap32(uint32_t v)
+  {
+#if defined(__GNUC__)
+    return __builtin_bswap32(v);
+#else
+    return ((v & 0xff) << 24) | ((v & 0xff00) << 8) | ((v >> 8) & 0xff00) | (v >> 24);
+#endif
+  }
+
+  inline uint64_t byteSwap64(uint64_t v)
+  {
+#if defined(__GNUC__)
+    return __builtin_bswap64(v);
+#else
+    return (static_cast<uint64_t>(byteSwap32(static_cast<uint32_t>(v))) << 32) | byteSwap32(static_cast<uint32_t>(v >> 32));
+#endif
+  }
+
+  // Scalar reference implementation, also used for the tails of the SIMD kernels
+  inline void swapCopyScalar(uint8_t *dst, const uint8_t *src, size_t count, size_t width)
+  {
+    for (size_t i = 0; i < count; ++i, dst += width, src += width)
+    {
+      if (width == 2)
+      {
+        uint16_t v;
+        std::memcpy(&v, src, 2);
+        v = byteSwap16(v);
+        std::memcpy(dst, &v, 2);
+      }
+      else if (width == 4)
+      {
+        uint32_t v;
+        std::memcpy(&v, src, 4);
+        v = byteSwap32(v);
+        std::memcpy(dst, &v, 4);
+      }
+      else
+      {
+        uint64_t v;
+        std::memcpy(&v, src, 8);
+        v = byteSwap64(v);
+        std::memcpy(dst, &v, 8);
+      }
+    }
+  }
+
+#ifdef SERIALIZATION_X86_SIMD
+  // Shuffle control reversing every `width` byte lane of a 16 byte vector
+  inline void byteSwapMask(uint8_t *mask, size_t width)
+  {
+    for (size_t i = 0; i < 16; ++i)
+      mask[i] = static_cast<uint8_t>(i - i % width + (width - 1 - i % width));
+  }
+
+  __attribute__((target("avx2"))) inline size_t swapCopyAvx2(uint8_t *dst, const uint8_t *src, size_t bytes, size_t width)
+  {
+    uint8_t m[16];
+    byteSwapMask(m, width);
+    __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+    __m256i mask = _mm256_broadcastsi128_si256(half);
+    size_t done = 0;
+    for (; done + 32 <= bytes; done += 32)
+    {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + done), _mm256_shuffle_epi8(v, mask));
+    }
+    return done;
+  }
+
+  __attribute__((target("ssse3"))) inline size_t swapCopySsse3(uint8_t *dst, const uint8_t *src, size_t bytes, size_t width)
+  {
+    uint8_t m[16];
+    byteSwapMask(m, width);
+    __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m));
+    size_t done = 0;
+    for (; done + 16 <= bytes; done += 16)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + done), _mm_shuffle_epi8(v, mask));
+    }
+    return done;
+  }
+
+  enum class SwapKernel { Scalar, Ssse3, Avx2 };
+
+  inline SwapKernel detectSwapKernel()
+  {
+    static const SwapKernel kernel = []
+    {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return SwapKernel::Avx2;
+      if (__builtin_cpu_supports("ssse3"))
+        return SwapKernel::Ssse3;
+      return SwapKernel::Scalar;
+    }();
+    return kernel;
+  }
+#endif
+
+  // Copies `count` elements of `width` (2, 4 or 8) bytes from src to dst reversing
+  // the bytes of each one. src and dst may be unaligned, and must either be the same
+  // buffer (an in-place swap) or not overlap.
+  inline void swapCopy(void *dstPtr, const void *srcPtr, size_t count, size_t width)
+  {
+    uint8_t *dst = static_cast<uint8_t *>(dstPtr);
+    const uint8_t *src = static_cast<const uint8_t *>(srcPtr);
+    size_t bytes = count * width;
+    size_t done = 0;
+#if defined(SERIALIZATION_X86_SIMD)
+    switch (detectSwapKernel())
+    {
+    case SwapKernel::Avx2:
+      done = swapCopyAvx2(dst, src, bytes, width);
+      break;
+    case SwapKernel::Ssse3:
+      done = swapCopySsse3(dst, src, bytes, width);
+      break;
+    default:
+      break;
+    }
+#elif defined(SERIALIZATION_NEON)
+    for (; done + 16 <= bytes; done += 16)
+    {
+      uint8x16_t v = vld1q_u8(src + done);
+      v = width == 2 ? vrev16q_u8(v) : width == 4 ? vrev32q_u8(v) : vrev64q_u8(v);
+      vst1q_u8(dst + done, v);
+    }
+#endif
+    swapCopyScalar(dst + done, src + done, (bytes - done) / width, width);
+  }
+
+  // Copies one scalar between host and wire order
+  template <typename T>
+  inline void swapScalar(void *dst, const void *src)
+  {
+    swapCopyScalar(static_cast<uint8_t *>(dst), static_cast<const uint8_t *>(src), 1, sizeof(T));
+  }
+
+  // Loads a fixed-width scalar stored in `order` from possibly unaligned memory
+  template <typename T>
+  inline T loadFixed(const uint8_t *p, ByteOrder order)
+  {
+    T v;
+    if (needsByteSwap(order))
+      swapScalar<T>(&v, p);
+    else
+      std::memcpy(&v, p, sizeof(T));
+    return v;
+  }
+
+} // namespace Serialization
+
+#endif // _BYTE_ORDER_HPP_
@@ -0,0 +1,125 @@
+#ifndef _COMPRESSED_HPP_
+#define _COMPRESSED_HPP_
+
+#include "Serialization.hpp"
+
+namespace Serialization
+{
+  // =====================
+  // Compressed values
+  // =====================
+  // A value serialized in the surrounding format and written as a compressed frame
+  // (see Serializer::writeCompressed). Use compress(value) to write a whole message or
+  // one large field, and Compressed<T> to read it back.
+
+  // Encodes the frame once per format, so the size pre-pass and the write that
+  // follows it do not compress twice
+  class CompressedFrame
+  {
+  public:
+    template <typename T>
+    const std::vector<uint8_t> &encode(const T &value, const WireFormat &format, const CompressionOptions &options) const
+    {
+      if (!valid || format != fmt)
+      {
+        Serializer plain;
+        plain.setFormat(format);
+        plain.write(value);
+        Serializer framed;
+        framed.setFormat(format);
+        framed.writeCompressed(plain.data(), plain.dataLength(), options);
+        frame = framed.release();
+        fmt = format;
+        valid = true;
+      }
+      return frame;
+    }
+
+    void invalidate() { valid = false; }
+
+  private:
+    mutable std::vector<uint8_t> frame;
+    mutable WireFormat fmt;
+    mutable bool valid = false;
+  };
+
+  template <typename T>
+  class CompressedWriter
+  {
+  public:
+    CompressedWriter(const T &value, const CompressionOptions &options) : value(value), options(options) {}
+
+    void serialize(Serializer *s) const
+    {
+      const std::vector<uint8_t> &frame = cache.encode(value, s->format(), options);
+      s->writeRaw(frame.data(), frame.size());
+    }
+
+  private:
+    const T &value;
+    CompressionOptions options;
+    CompressedFrame cache;
+  };
+
+  template <typename T>
+  CompressedWriter<T> compress(const T &value, const CompressionOptions &options = CompressionOptions())
+  {
+    return CompressedWriter<T>(value, options);
+  }
+
+  // Field that owns its value, options.threads also applies to decompression. A value
+  // read with setZeroCopy() may point into the decompressed bytes, which the field keeps.
+  template <typename T>
+  class Compressed
+  {
+  public:
+    Compressed() = default;
+    Compressed(const T &v, const CompressionOptions &options = CompressionOptions()) : value(v), options(options) {}
+    Compressed(T &&v, const CompressionOptions &options = CompressionOptions()) : value(std::move(v)), options(options) {}
+
+    const T &get() const { return value; }
+
+    // Mutable access drops the cached frame
+    T &get()
+    {
+      cache.invalidate();
+      return value;
+    }
+
+    const T &operator*() const { return get(); }
+    T &operator*() { return get(); }
+    const T *operator->() const { return &get(); }
+    T *operator->() { return &get(); }
+
+    void setOptions(const CompressionOptions &o)
+    {
+      options = o;
+      cache.invalidate();
+    }
+
+    void serialize(Serializer *s) const
+    {
+      const std::vector<uint8_t> &frame = cache.encode(value, s->format(), options);
+      s->writeRaw(frame.data(), frame.size());
+    }
+
+    void deserialize(Deserializer *d)
+    {
+      cache.invalidate();
+      Deserializer inner = d->readCompressed(options.threads);
+      inner.read(value);
+      if (inner.remaining() != 0)
+        throw std::runtime_error("Malformed compressed frame");
+      owner = inner.owner();
+    }
+
+  private:
+    T value{};
+    std::shared_ptr<const void> owner;
+    CompressionOptions options;
+    CompressedFrame cache;
+  };
+
+} // namespace Serialization
+
+#endif // _COMPRESSED_HPP_
@@ -0,0 +1,372 @@
+#ifndef _COMPRESSION_HPP_
+#define _COMPRESSION_HPP_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+namespace Serialization
+{
+  // =====================
+  // Block compression
+  // =====================
+  // LZ77 block codec in the LZ4 style: greedy hash matching, no entropy stage.
+  // A block is a series of sequences:
+  //   [token: literal length << 4 | (match length - MinMatch)]
+  //   [literal length extension bytes][literals]
+  //   [match offset: 2 bytes little-endian][match length extension bytes]
+  // A nibble of 15 is followed by extension bytes that are added up until one is
+  // below 255. The last sequence has literals only and ends the block.
+
+  struct CompressionOptions
+  {
+    // Payloads smaller than this are stored uncompressed
+    size_t threshold = 64 * 1024;
+    // Independently compressed block size, blocks are compressed in parallel
+    size_t blockSize = 1024 * 1024;
+    // Worker threads for multi-block payloads, 0 uses the hardware concurrency
+    unsigned threads = 0;
+  };
+
+  namespace lz
+  {
+    const size_t MinMatch = 4;
+    const size_t MaxOffset = 65535;
+    const unsigned HashBits = 14;
+    // Matches may not start in the last bytes of a block, the tail is literals
+    const size_t TailLiterals = 8;
+
+    inline uint32_t load32(const uint8_t *p)
+    {
+      uint32_t v;
+      std::memcpy(&v, p, 4);
+      return v;
+    }
+
+    inline uint32_t hash(uint32_t v)
+    {
+      return (v * 2654435761u) >> (32 - HashBits);
+    }
+
+    inline void writeExtension(uint8_t *&out, size_t n)
+    {
+      while (n >= 255)
+      {
+        *out++ = 255;
+        n -= 255;
+      }
+      *out++ = static_cast<uint8_t>(n);
+    }
+
+    inline void writeSequence(uint8_t *&out, const uint8_t *literals, size_t literalLength,
+                              size_t offset, size_t matchLength)
+    {
+      uint8_t *token = out++;
+      *token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+      if (literalLength >= 15)
+        writeExtension(out, literalLength - 15);
+      // Empty input may come with null pointers
+      if (literalLength)
+        std::memcpy(out, literals, literalLength);
+      out += literalLength;
+      if (matchLength == 0)
+        return;
+      *out++ = static_cast<uint8_t>(offset);
+      *out++ = static_cast<uint8_t>(offset >> 8);
+      size_t code = matchLength - MinMatch;
+      *token |= static_cast<uint8_t>(std::min<size_t>(code, 15));
+      if (code >= 15)
+        writeExtension(out, code - 15);
+    }
+
+    inline size_t readExtension(const uint8_t *&in, const uint8_t *end, size_t n)
+    {
+      if (n != 15)
+        return n;
+      uint8_t b;
+      do
+      {
+        if (in == end)
+          throw std::runtime_error("Malformed compressed block");
+        b = *in++;
+        n += b;
+      } while (b == 255);
+      return n;
+    }
+  } // namespace lz
+
+  // Worst-case compressed size of `n` bytes
+  inline size_t compressBound(size_t n)
+  {
+    return n + n / 255 + 16;
+  }
+
+  // Compresses `n` bytes into `out`, which must hold compressBound(n) bytes.
+  // Returns the compressed size.
+  inline size_t compressBlock(const uint8_t *in, size_t n, uint8_t *out)
+  {
+    uint8_t *const start = out;
+    const uint8_t *anchor = in;
+    if (n > lz::TailLiterals + lz::MinMatch)
+    {
+      std::vector<uint32_t> table(size_t(1) << lz::HashBits, 0);
+      const uint8_t *const matchLimit = in + n - lz::TailLiterals;
+      const uint8_t *ip = in + 1;
+      // Skip faster through incompressible data
+      unsigned misses = 0;
+      while (ip < matchLimit)
+      {
+        uint32_t seq = lz::load32(ip);
+        uint32_t &slot = table[lz::hash(seq)];
+        const uint8_t *ref = in + slot;
+        slot = static_cast<uint32_t>(ip - in);
+        if (ref >= ip || static_cast<size_t>(ip - ref) > lz::MaxOffset || lz::load32(ref) != seq)
+        {
+          ip += 1 + (misses++ >> 5);
+          continue;
+        }
+        misses = 0;
+
+        // Extend backwards over pending literals, then forwards
+        while (ip > anchor && ref > in && ip[-1] == ref[-1])
+        {
+          --ip;
+          --ref;
+        }
+        const uint8_t *matchEnd = ip + lz::MinMatch;
+        const uint8_t *refEnd = ref + lz::MinMatch;
+        while (matchEnd < matchLimit && *matchEnd == *refEnd)
+        {
+          ++matchEnd;
+          ++refEnd;
+        }
+
+        lz::writeSequence(out, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref),
+                          static_cast<size_t>(matchEnd - ip));
+        ip = anchor = matchEnd;
+        if (ip < matchLimit)
+          table[lz::hash(lz::load32(ip - 2))] = static_cast<uint32_t>(ip - 2 - in);
+      }
+    }
+    lz::writeSequence(out, anchor, static_cast<size_t>(in + n - anchor), 0, 0);
+    return static_cast<size_t>(out - start);
+  }
+
+  // Decompresses a block that must expand to exactly `outLength` bytes
+  inline void decompressBlock(const uint8_t *in, size_t n, uint8_t *out, size_t outLength)
+  {
+    const uint8_t *const inEnd = in + n;
+    uint8_t *const outStart = out;
+    uint8_t *const outEnd = out + outLength;
+    while (true)
+    {
+      if (in == inEnd)
+        throw std::runtime_error("Malformed compressed block");
+      uint8_t token = *in++;
+      size_t literals = lz::readExtension(in, inEnd, token >> 4);
+      if (literals > static_cast<size_t>(inEnd - in) || literals > static_cast<size_t>(outEnd - out))
+        throw std::runtime_error("Malformed compressed block");
+      if (literals)
+        std::memcpy(out, in, literals);
+      in += literals;
+      out += literals;
+      if (in == inEnd)
+        break;
+
+      if (inEnd - in < 2)
+        throw std::runtime_error("Malformed compressed block");
+      size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+      in += 2;
+      size_t length = lz::readExtension(in, inEnd, token & 15) + lz::MinMatch;
+      if (offset == 0 || offset > static_cast<size_t>(out - outStart) || length > static_cast<size_t>(outEnd - out))
+        throw std::runtime_error("Malformed compressed block");
+      // An overlapping match repeats the last `offset` bytes, the copied
+      // pattern doubles with every step
+      const uint8_t *ref = out - offset;
+      while (length > 0)
+      {
+        size_t chunk = std::min(length, static_cast<size_t>(out - ref));
+        std::memcpy(out, ref, chunk);
+        out += chunk;
+        length -= chunk;
+      }
+    }
+    if (out != outEnd)
+      throw std::runtime_error("Malformed compressed block");
+  }
+
+  // Runs fn(i) for i in [0, count) on up to `threads` threads, the first exception is rethrown
+  template <typename Fn>
+  void parallelFor(size_t count, unsigned threads, Fn fn)
+  {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+    if (threads <= 1)
+    {
+      for (size_t i = 0; i < count; ++i)
+        fn(i);
+      return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]
+    {
+      for (size_t i = next++; i < count; i = next++)
+      {
+        try
+        {
+          fn(i);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t)
+      pool.emplace_back(worker);
+    worker();
+    for (std::thread &t : pool)
+      t.join();
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  // Worker threads kept across runs, for callers that would otherwise start and join a
+  // parallelFor() pool several times per value. run() is not reentrant and is called
+  // from one thread at a time.
+  class WorkerPool
+  {
+  public:
+    // `threads` counts the calling thread, 0 uses the hardware concurrency
+    explicit WorkerPool(unsigned threads)
+    {
+      if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+      workers.reserve(threads - 1);
+      for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back([this]
+                             { loop(); });
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    ~WorkerPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      wake.notify_all();
+      for (std::thread &t : workers)
+        t.join();
+    }
+
+    unsigned threads() const
+    {
+      return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    // Runs fn(i) for i in [0, count) on the workers and the calling thread, the first
+    // exception is rethrown
+    template <typename Fn>
+    void run(size_t count, Fn fn)
+    {
+      if (workers.empty() || count <= 1)
+      {
+        for (size_t i = 0; i < count; ++i)
+          fn(i);
+        return;
+      }
+
+      std::function<void(size_t)> task(std::ref(fn));
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        jobCount = count;
+        next = 0;
+        error = nullptr;
+        busy = workers.size();
+        ++generation;
+      }
+      wake.notify_all();
+      work();
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [this]
+                { return busy == 0; });
+      job = nullptr;
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    // Bumped for every run(), each worker takes part in each run once
+    uint64_t generation = 0;
+    size_t busy = 0;
+    std::function<void(size_t)> *job = nullptr;
+    size_t jobCount = 0;
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+
+    void loop()
+    {
+      uint64_t seen = 0;
+      while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          wake.wait(lock, [&]
+                    { return stopping || generation != seen; });
+          if (stopping)
+            return;
+          seen = generation;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+          done.notify_one();
+      }
+    }
+
+    void work()
+    {
+      for (size_t i = next++; i < jobCount; i = next++)
+      {
+        try
+        {
+          (*job)(i);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    }
+  };
+
+} // namespace Serialization
+
+#endif // _COMPRESSION_HPP_
@@ -0,0 +1,184 @@
+#ifndef _CRC32C_HPP_
+#define _CRC32C_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define SERIALIZATION_CRC_SSE42 1
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define SERIALIZATION_CRC_ARM 1
+#endif
+
+namespace Serialization
+{
+  // =====================
+  // CRC32C (Castagnoli)
+  // =====================
+  namespace crc
+  {
+    // Reflected polynomial
+    const uint32_t Poly = 0x82f63b78u;
+
+    // Slicing-by-8 tables for the portable kernel
+    inline const uint32_t (&tables())[8][256]
+    {
+      static uint32_t table[8][256];
+      static const bool built = []
+      {
+        for (uint32_t n = 0; n < 256; ++n)
+        {
+          uint32_t c = n;
+          for (int k = 0; k < 8; ++k)
+            c = c & 1 ? (c >> 1) ^ Poly : c >> 1;
+          table[0][n] = c;
+        }
+        for (uint32_t n = 0; n < 256; ++n)
+          for (int t = 1; t < 8; ++t)
+            table[t][n] = (table[t - 1][n] >> 8) ^ table[0][table[t - 1][n] & 0xff];
+        return true;
+      }();
+      (void)built;
+      return table;
+    }
+
+    // Kernels update a raw (non-inverted) CRC state
+    inline uint32_t updatePortable(uint32_t crc, const uint8_t *p, size_t n)
+    {
+      const uint32_t(&t)[8][256] = tables();
+      for (; n >= 8; p += 8, n -= 8)
+      {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        lo ^= crc;
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+      }
+      for (; n > 0; --n)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+      return crc;
+    }
+
+    // a * b modulo Poly, both reflected
+    inline uint32_t multiplyModP(uint32_t a, uint32_t b)
+    {
+      uint32_t product = 0;
+      for (uint32_t m = 1u << 31; m != 0; m >>= 1)
+      {
+        if (a & m)
+          product ^= b;
+        b = b & 1 ? (b >> 1) ^ Poly : b >> 1;
+      }
+      return product;
+    }
+
+    // x^(8 * n) modulo Poly: multiplying a state by it appends n zero bytes
+    inline uint32_t zeroBytesOperator(size_t n)
+    {
+      uint32_t result = 1u << 31; // x^0
+      uint32_t square = 1u << 23; // x^8
+      for (; n > 0; n >>= 1)
+      {
+        if (n & 1)
+          result = multiplyModP(result, square);
+        square = multiplyModP(square, square);
+      }
+      return result;
+    }
+
+#if defined(SERIALIZATION_CRC_SSE42)
+    // Three independent crc32 streams hide the instruction latency, their states
+    // are merged by shifting the first two over the bytes that follow them
+    const size_t Lane = 8192;
+
+    __attribute__((target("sse4.2"))) inline uint32_t updateSse42(uint32_t crc, const uint8_t *p, size_t n)
+    {
+      static const uint32_t shiftOne = zeroBytesOperator(Lane);
+      static const uint32_t shiftTwo = zeroBytesOperator(2 * Lane);
+
+      for (; n > 0 && reinterpret_cast<uintptr_t>(p) & 7; --n)
+        crc = _mm_crc32_u8(crc, *p++);
+      for (; n >= 3 * Lane; p += 3 * Lane, n -= 3 * Lane)
+      {
+        uint64_t a = crc, b = 0, c = 0;
+        for (size_t k = 0; k < Lane; k += 8)
+        {
+          uint64_t va, vb, vc;
+          std::memcpy(&va, p + k, 8);
+          std::memcpy(&vb, p + Lane + k, 8);
+          std::memcpy(&vc, p + 2 * Lane + k, 8);
+          a = _mm_crc32_u64(a, va);
+          b = _mm_crc32_u64(b, vb);
+          c = _mm_crc32_u64(c, vc);
+        }
+        crc = multiplyModP(shiftTwo, static_cast<uint32_t>(a)) ^ multiplyModP(shiftOne, static_cast<uint32_t>(b)) ^
+              static_cast<uint32_t>(c);
+      }
+      uint64_t wide = crc;
+      for (; n >= 8; p += 8, n -= 8)
+      {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        wide = _mm_crc32_u64(wide, v);
+      }
+      crc = static_cast<uint32_t>(wide);
+      for (; n > 0; --n)
+        crc = _mm_crc32_u8(crc, *p++);
+      return crc;
+    }
+
+    inline bool hasSse42()
+    {
+      static const bool supported = []
+      {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+      }();
+      return supported;
+    }
+#elif defined(SERIALIZATION_CRC_ARM)
+    inline uint32_t updateArm(uint32_t crc, const uint8_t *p, size_t n)
+    {
+      for (; n >= 8; p += 8, n -= 8)
+      {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+      }
+      for (; n > 0; --n)
+        crc = __crc32cb(crc, *p++);
+      return crc;
+    }
+#endif
+  } // namespace crc
+
+  // CRC32C of `n` bytes. Pass the previous result as `crc` to continue a checksum
+  // over consecutive buffers.
+  inline uint32_t crc32c(const void *data, size_t n, uint32_t crc = 0)
+  {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    uint32_t state = ~crc;
+#if defined(SERIALIZATION_CRC_SSE42)
+    state = crc::hasSse42() ? crc::updateSse42(state, p, n) : crc::updatePortable(state, p, n);
+#elif defined(SERIALIZATION_CRC_ARM)
+    state = crc::updateArm(state, p, n);
+#else
+    state = crc::updatePortable(state, p, n);
+#endif
+    return ~state;
+  }
+
+  // Size of the checksum trailer
+  const size_t ChecksumSize = sizeof(uint32_t);
+
+} // namespace Serialization
+
+#endif // _CRC32C_HPP_
@@ -0,0 +1,130 @@
+#ifndef _FRAME_DECODER_HPP_
+#define _FRAME_DECODER_HPP_
+
+#include "Serialization.hpp"
+
+namespace Serialization
+{
+  // Payload capacity a FrameDecoder reserves when a frame's length is known
+  const size_t FrameInitialReserve = 64 * 1024;
+
+  // =====================
+  // Resumable frame decoding
+  // =====================
+  // Frames are written with Serializer::writeFrame(). A FrameDecoder is fed a stream of
+  // frames in chunks of any size, e.g. as they come off a non-blocking socket, and keeps
+  // its progress between calls. A short chunk is not an error, it only leaves the decoder
+  // waiting for more:
+  //
+  //   for (size_t used = 0; used < n;)
+  //   {
+  //     used += decoder.feed(chunk + used, n - used);
+  //     if (decoder.ready())
+  //       handle(decoder.message().read<Message>());
+  //   }
+  class FrameDecoder
+  {
+  public:
+    enum class State
+    {
+      Length,  // collecting the length prefix
+      Payload, // collecting payload bytes
+      Ready    // a complete frame waits for message()
+    };
+
+    // Frames longer than maxFrameSize are rejected before anything is allocated. The
+    // payload buffer grows as bytes arrive, so a bogus length below the limit does not
+    // commit memory up front either.
+    explicit FrameDecoder(const WireFormat &format = WireFormat(), size_t maxFrameSize = size_t(64) << 20)
+        : fmt(format), maxFrameSize(maxFrameSize) {}
+
+    // Consumes bytes up to the end of the current frame and returns how many were used.
+    // Uses nothing while a completed frame has not been taken with message().
+    size_t feed(const uint8_t *p, size_t n)
+    {
+      size_t used = 0;
+      if (current == State::Length)
+        used += feedLength(p, n);
+      if (current == State::Payload)
+      {
+        size_t take = std::min(n - used, expectedLength - payload->size());
+        payload->insert(payload->end(), p + used, p + used + take);
+        used += take;
+        if (payload->size() == expectedLength)
+          current = State::Ready;
+      }
+      return used;
+    }
+
+    State state() const { return current; }
+    bool ready() const { return current == State::Ready; }
+
+    // Progress of the current frame, its length is known once past State::Length
+    size_t received() const { return payload ? payload->size() : 0; }
+    size_t expected() const { return current == State::Length ? 0 : expectedLength; }
+
+    // Deserializer over the completed frame, which keeps its bytes alive. The decoder
+    // moves on to the next frame.
+    Deserializer message()
+    {
+      if (current != State::Ready)
+        throw std::runtime_error("No complete frame");
+      Deserializer d(std::shared_ptr<const std::vector<uint8_t>>(std::move(payload)));
+      d.setFormat(fmt);
+      payload.reset();
+      headerLength = 0;
+      current = State::Length;
+      return d;
+    }
+
+  private:
+    WireFormat fmt;
+    size_t maxFrameSize;
+    State current = State::Length;
+    uint8_t header[MaxVarintSize];
+    size_t headerLength = 0;
+    size_t expectedLength = 0;
+    std::shared_ptr<std::vector<uint8_t>> payload;
+
+    size_t feedLength(const uint8_t *p, size_t n)
+    {
+      size_t used = 0;
+      uint64_t length = 0;
+      bool complete = false;
+      if (fmt.lengths == LengthEncoding::Varint)
+      {
+        // One byte at a time, the prefix ends at the first byte without a continuation bit
+        while (!complete && used < n)
+        {
+          header[headerLength++] = p[used++];
+          complete = decodeVarint(header, headerLength, length) != 0;
+          if (!complete && headerLength == MaxVarintSize)
+            throw std::runtime_error("Malformed frame length");
+        }
+      }
+      else
+      {
+        size_t take = std::min(n, sizeof(uint64_t) - headerLength);
+        std::memcpy(header + headerLength, p, take);
+        headerLength += take;
+        used = take;
+        complete = headerLength == sizeof(uint64_t);
+        if (complete)
+          length = loadFixed<uint64_t>(header, fmt.byteOrder);
+      }
+      if (!complete)
+        return used;
+
+      if (length > maxFrameSize)
+        throw std::runtime_error("Frame too large");
+      expectedLength = static_cast<size_t>(length);
+      payload = std::make_shared<std::vector<uint8_t>>();
+      payload->reserve(std::min(expectedLength, FrameInitialReserve));
+      current = expectedLength ? State::Payload : State::Ready;
+      return used;
+    }
+  };
+
+} // namespace Serialization
+
+#endif // _FRAME_DECODER_HPP_
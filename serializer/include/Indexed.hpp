@@ -0,0 +1,319 @@
+#ifndef _INDEXED_HPP_
+#define _INDEXED_HPP_
+
+#include "Serialization.hpp"
+
+// Random-access container encodings
+//
+// Sequence: [count][width u8][payload size][element offsets x count][elements]
+// Map:      [count][width u8][bucket count][payload size][bucket starts x (buckets + 1)]
+//           [entry offsets x count][key value entries grouped by bucket]
+//
+// Offsets and table entries are `width` (4 or 8) byte fixed-width integers in the wire
+// byte order. Offsets are relative to the start of the payload. Map buckets are chosen
+// by hashing the serialized key bytes, so lookups never decode other entries.
+
+namespace Serialization
+{
+  // FNV-1a over serialized key bytes, stable across processes and hosts
+  inline uint64_t hashBytes(const uint8_t *p, size_t n)
+  {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+      h ^= p[i];
+      h *= 0x100000001b3ull;
+    }
+    return h;
+  }
+
+  template <typename Seq>
+  void Serializer::writeIndexedSequence(const Seq &seq)
+  {
+    std::vector<uint64_t> offsets;
+    offsets.reserve(seq.size());
+    uint64_t payload = 0;
+    for (const auto &v : seq)
+    {
+      offsets.push_back(payload);
+      payload += serializedSize(v, fmt);
+    }
+    uint8_t width = payload > UINT32_MAX ? 8 : 4;
+    writeLength(seq.size());
+    writeBytes(&width, 1);
+    writeOffset(payload, width);
+    for (uint64_t o : offsets)
+      writeOffset(o, width);
+    // The elements were just measured
+    if (measuring)
+    {
+      measured += payload;
+      return;
+    }
+    for (const auto &v : seq)
+      write(v);
+  }
+
+  template <typename Map>
+  void Serializer::writeIndexedMap(const Map &map)
+  {
+    struct Item
+    {
+      const typename Map::value_type *entry;
+      uint64_t bucket;
+      uint64_t size;
+    };
+    const uint64_t count = map.size();
+    const uint64_t buckets = count ? count : 1;
+
+    std::vector<Item> items;
+    items.reserve(count);
+    Serializer keyBytes;
+    keyBytes.fmt = fmt;
+    for (const auto &e : map)
+    {
+      keyBytes.reset();
+      keyBytes.write(e.first);
+      uint64_t bucket = hashBytes(keyBytes.data(), keyBytes.dataLength()) % buckets;
+      items.push_back({&e, bucket, keyBytes.dataLength() + serializedSize(e.second, fmt)});
+    }
+
+    // Counting sort of the entries by bucket
+    std::vector<uint64_t> bucketStarts(buckets + 1, 0);
+    for (const Item &item : items)
+      ++bucketStarts[item.bucket + 1];
+    for (uint64_t b = 0; b < buckets; ++b)
+      bucketStarts[b + 1] += bucketStarts[b];
+    std::vector<const Item *> ordered(count);
+    std::vector<uint64_t> fill(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (const Item &item : items)
+      ordered[fill[item.bucket]++] = &item;
+
+    uint64_t payload = 0;
+    for (const Item *item : ordered)
+      payload += item->size;
+    uint8_t width = payload > UINT32_MAX || count > UINT32_MAX ? 8 : 4;
+
+    writeLength(count);
+    writeBytes(&width, 1);
+    writeOffset(buckets, width);
+    writeOffset(payload, width);
+    for (uint64_t start : bucketStarts)
+      writeOffset(start, width);
+    uint64_t offset = 0;
+    for (const Item *item : ordered)
+    {
+      writeOffset(offset, width);
+      offset += item->size;
+    }
+    if (measuring)
+    {
+      measured += payload;
+      return;
+    }
+    for (const Item *item : ordered)
+    {
+      write(item->entry->first);
+      write(item->entry->second);
+    }
+  }
+
+  // Writes a container with the indexed encoding: s.write(indexed(container))
+  template <typename C>
+  class IndexedWriter
+  {
+  public:
+    explicit IndexedWriter(const C &c) : c(c) {}
+
+    void serialize(Serializer *s) const
+    {
+      write(s, is_map_like<C>{});
+    }
+
+  private:
+    const C &c;
+
+    void write(Serializer *s, std::true_type) const { s->writeIndexedMap(c); }
+    void write(Serializer *s, std::false_type) const { s->writeIndexedSequence(c); }
+  };
+
+  template <typename C>
+  IndexedWriter<C> indexed(const C &c)
+  {
+    return IndexedWriter<C>(c);
+  }
+
+  // Offset table shared by the indexed views
+  class IndexTable
+  {
+  public:
+    // Reads count, width, `extras` table-specific header fields and the payload size
+    void read(Deserializer *d, uint64_t &count, uint64_t *extra, size_t extras)
+    {
+      fmt = d->format();
+      count = d->readLength();
+      d->readFixed(width);
+      if (width != 4 && width != 8)
+        throw std::runtime_error("Malformed index");
+      for (size_t k = 0; k < extras; ++k)
+        extra[k] = readOffset(d);
+      payloadSize = readOffset(d);
+    }
+
+    uint64_t readOffset(Deserializer *d)
+    {
+      return load(d->readRaw(width), 0);
+    }
+
+    // Reads `entries` table entries followed by the payload, returns the table
+    const uint8_t *readBody(Deserializer *d, uint64_t entries)
+    {
+      if (entries > UINT64_MAX / width || payloadSize > UINT64_MAX - entries * width)
+        throw std::runtime_error("Malformed index");
+      const uint8_t *table = d->readShared(entries * width + payloadSize, owner);
+      payload = table + entries * width;
+      return table;
+    }
+
+    uint64_t load(const uint8_t *table, uint64_t i) const
+    {
+      const uint8_t *p = table + i * width;
+      return width == 4 ? loadFixed<uint32_t>(p, fmt.byteOrder) : loadFixed<uint64_t>(p, fmt.byteOrder);
+    }
+
+    // Deserializer over payload bytes [begin, end)
+    Deserializer slice(uint64_t begin, uint64_t end) const
+    {
+      if (begin > end || end > payloadSize)
+        throw std::runtime_error("Malformed index");
+      Deserializer d(payload + begin, static_cast<size_t>(end - begin), owner);
+      d.setFormat(fmt);
+      return d;
+    }
+
+    WireFormat fmt;
+    std::shared_ptr<const void> owner;
+    const uint8_t *payload = nullptr;
+    uint64_t payloadSize = 0;
+    uint8_t width = 0;
+  };
+
+  // Random-access view of an indexed sequence. Like Span it points into the input
+  // buffer, which must outlive it unless the Deserializer had an owner().
+  template <typename T>
+  class IndexedSequence
+  {
+  public:
+    size_t size() const { return static_cast<size_t>(count); }
+    bool empty() const { return count == 0; }
+
+    // Decodes element i only
+    void read(size_t i, T &out) const
+    {
+      Deserializer d = slice(i);
+      d.read(out);
+    }
+
+    // Decodes element i with Deserializer::read<T>(), T need not be default constructible
+    T at(size_t i) const
+    {
+      Deserializer d = slice(i);
+      return d.read<T>();
+    }
+
+    void deserialize(Deserializer *d)
+    {
+      index.read(d, count, nullptr, 0);
+      offsets = index.readBody(d, count);
+    }
+
+  private:
+    IndexTable index;
+    uint64_t count = 0;
+    const uint8_t *offsets = nullptr;
+
+    Deserializer slice(size_t i) const
+    {
+      if (i >= count)
+        throw std::out_of_range("IndexedSequence index out of range");
+      uint64_t begin = index.load(offsets, i);
+      uint64_t end = i + 1 < count ? index.load(offsets, i + 1) : index.payloadSize;
+      return index.slice(begin, end);
+    }
+  };
+
+  // Hash-indexed view of a map, find() decodes only the matching entry
+  template <typename K, typename V>
+  class IndexedMap
+  {
+  public:
+    size_t size() const { return static_cast<size_t>(count); }
+    bool empty() const { return count == 0; }
+
+    bool find(const K &key, V &out) const
+    {
+      uint64_t begin, end;
+      size_t keyLength;
+      if (!locate(key, begin, end, keyLength))
+        return false;
+      Deserializer d = index.slice(begin + keyLength, end);
+      d.read(out);
+      return true;
+    }
+
+    bool contains(const K &key) const
+    {
+      uint64_t begin, end;
+      size_t keyLength;
+      return locate(key, begin, end, keyLength);
+    }
+
+    void deserialize(Deserializer *d)
+    {
+      index.read(d, count, &buckets, 1);
+      if (buckets == 0)
+        throw std::runtime_error("Malformed index");
+      if (buckets > UINT64_MAX - 1 - count)
+        throw std::runtime_error("Malformed index");
+      bucketStarts = index.readBody(d, buckets + 1 + count);
+      offsets = bucketStarts + (buckets + 1) * index.width;
+    }
+
+  private:
+    IndexTable index;
+    uint64_t count = 0;
+    uint64_t buckets = 0;
+    const uint8_t *bucketStarts = nullptr;
+    const uint8_t *offsets = nullptr;
+
+    // Finds the entry whose serialized key equals the serialized probe key. Encodings
+    // are self-delimiting, so a byte prefix match is an exact key match.
+    bool locate(const K &key, uint64_t &begin, uint64_t &end, size_t &keyLength) const
+    {
+      if (count == 0)
+        return false;
+      Serializer probe;
+      probe.setFormat(index.fmt);
+      probe.write(key);
+      keyLength = probe.dataLength();
+      uint64_t bucket = hashBytes(probe.data(), keyLength) % buckets;
+      uint64_t first = index.load(bucketStarts, bucket);
+      uint64_t last = index.load(bucketStarts, bucket + 1);
+      if (first > last || last > count)
+        throw std::runtime_error("Malformed index");
+      for (uint64_t e = first; e < last; ++e)
+      {
+        begin = index.load(offsets, e);
+        end = e + 1 < count ? index.load(offsets, e + 1) : index.payloadSize;
+        if (begin > end || end > index.payloadSize)
+          throw std::runtime_error("Malformed index");
+        if (end - begin >= keyLength && std::memcmp(index.payload + begin, probe.data(), keyLength) == 0)
+          return true;
+      }
+      return false;
+    }
+  };
+
+} // namespace Serialization
+
+#endif // _INDEXED_HPP_
@@ -0,0 +1,119 @@
+#ifndef _LAZY_HPP_
+#define _LAZY_HPP_
+
+#include "Serialization.hpp"
+
+namespace Serialization
+{
+  // =====================
+  // Lazy fields
+  // =====================
+  // Wire layout: [length][value]. Reading a Lazy<T> only checks the length against the
+  // input and records the byte range, the value is decoded on first access. Like Span,
+  // the recorded range points into the input buffer, which must outlive the Lazy unless
+  // the Deserializer had an owner(). Not safe for concurrent first access.
+  template <typename T>
+  class Lazy
+  {
+  public:
+    Lazy() = default;
+    Lazy(const T &v) : value(v), decoded(true) {}
+    Lazy(T &&v) : value(std::move(v)), decoded(true) {}
+
+    Lazy &operator=(const T &v)
+    {
+      value = v;
+      setDecoded();
+      return *this;
+    }
+
+    Lazy &operator=(T &&v)
+    {
+      value = std::move(v);
+      setDecoded();
+      return *this;
+    }
+
+    // True once the value has been decoded or assigned
+    bool loaded() const { return decoded; }
+
+    // Size of the recorded encoding, 0 when the value was not read from a Deserializer
+    size_t encodedSize() const { return encoded ? encodedLength : 0; }
+
+    const T &get() const
+    {
+      if (!decoded)
+        decode();
+      return value;
+    }
+
+    // Mutable access, the recorded bytes are dropped since the value may change
+    T &get()
+    {
+      if (!decoded)
+        decode();
+      setDecoded();
+      return value;
+    }
+
+    const T &operator*() const { return get(); }
+    T &operator*() { return get(); }
+    const T *operator->() const { return &get(); }
+    T *operator->() { return &get(); }
+
+    // Undecoded bytes in the same wire format are copied through without a decode
+    void serialize(Serializer *s) const
+    {
+      if (encoded && s->fmt == fmt)
+      {
+        s->writeLength(encodedLength);
+        s->writeBytes(encoded, encodedLength);
+        return;
+      }
+      const T &v = get();
+      size_t n = serializedSize(v, s->fmt);
+      s->writeLength(n);
+      s->writeMeasured(v, n);
+    }
+
+    void deserialize(Deserializer *d)
+    {
+      uint64_t len = d->readLength();
+      encoded = d->readShared(len, owner);
+      encodedLength = static_cast<size_t>(len);
+      fmt = d->fmt;
+      zeroCopy = d->zeroCopy;
+      decoded = false;
+    }
+
+  private:
+    mutable T value{};
+    mutable bool decoded = false;
+    const uint8_t *encoded = nullptr;
+    size_t encodedLength = 0;
+    WireFormat fmt;
+    std::shared_ptr<const void> owner;
+    bool zeroCopy = false;
+
+    void decode() const
+    {
+      Deserializer d(encoded, encodedLength, owner);
+      d.fmt = fmt;
+      d.zeroCopy = zeroCopy;
+      d.read(value);
+      if (d.pos != d.size)
+        throw std::runtime_error("Malformed lazy field");
+      decoded = true;
+    }
+
+    void setDecoded()
+    {
+      decoded = true;
+      encoded = nullptr;
+      encodedLength = 0;
+    }
+  };
+
+} // namespace Serialization
+
+#endif // _LAZY_HPP_
@@ -0,0 +1,217 @@
+#ifndef _MAPPED_ARCHIVE_HPP_
+#define _MAPPED_ARCHIVE_HPP_
+
+#include "Serialization.hpp"
+
+#ifndef _WIN32
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Archive file: [header][Serializer output]
+//
+// Header, 16 bytes: "SRLZARCV" magic, version u8, length encoding u8, integer
+// encoding u8, byte order u8 (never Native), chunk index threshold u32 little endian.
+// The payload starts 16 bytes into a page-aligned mapping, so zero-copy Mat and Span
+// reads of aligned data stay aligned.
+
+namespace Serialization
+{
+  namespace archive
+  {
+    const char Magic[8] = {'S', 'R', 'L', 'Z', 'A', 'R', 'C', 'V'};
+    const uint8_t Version = 1;
+    const size_t HeaderSize = 16;
+  } // namespace archive
+
+  // Writes an archive through a staging buffer, see FdSink
+  class ArchiveWriter
+  {
+  public:
+    explicit ArchiveWriter(const std::string &path, const WireFormat &format = WireFormat())
+        : file{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)}, sink(file.fd), out(sink)
+    {
+      if (file.fd < 0)
+        throw std::runtime_error("Cannot create archive " + path);
+
+      WireFormat stored = format;
+      if (stored.byteOrder == ByteOrder::Native)
+        stored.byteOrder = hostIsLittleEndian() ? ByteOrder::Little : ByteOrder::Big;
+      uint8_t header[archive::HeaderSize] = {};
+      std::memcpy(header, archive::Magic, sizeof(archive::Magic));
+      header[8] = archive::Version;
+      header[9] = static_cast<uint8_t>(stored.lengths);
+      header[10] = static_cast<uint8_t>(stored.integers);
+      header[11] = static_cast<uint8_t>(stored.byteOrder);
+      for (int k = 0; k < 4; ++k)
+        header[12 + k] = static_cast<uint8_t>(stored.chunkIndexThreshold >> (8 * k));
+      out.writeRaw(header, sizeof(header));
+      out.setFormat(stored);
+    }
+
+    ArchiveWriter(const ArchiveWriter &) = delete;
+    ArchiveWriter &operator=(const ArchiveWriter &) = delete;
+
+    ~ArchiveWriter()
+    {
+      try
+      {
+        close();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    // Throws after close()
+    template <typename T>
+    void write(const T &value)
+    {
+      serializer().write(value);
+    }
+
+    // For checksums, frames and the other Serializer calls, throws after close()
+    Serializer &serializer()
+    {
+      if (file.fd < 0)
+        throw std::runtime_error("Archive is closed");
+      return out;
+    }
+
+    // Flushes and closes the file, throws when the data did not reach it
+    void close()
+    {
+      if (file.fd < 0)
+        return;
+      int closing = file.fd;
+      file.fd = -1;
+      try
+      {
+        out.flush();
+      }
+      catch (...)
+      {
+        sink.detach();
+        ::close(closing);
+        throw;
+      }
+      // A Serializer reference kept by the caller must not reach a reused descriptor
+      sink.detach();
+      if (::close(closing) != 0)
+        throw std::runtime_error("Closing archive failed");
+    }
+
+  private:
+    // Owns the descriptor, so it is closed when the constructor throws after open()
+    struct File
+    {
+      int fd;
+      ~File()
+      {
+        if (fd >= 0)
+          ::close(fd);
+      }
+    } file;
+    FdSink sink;
+    Serializer out;
+  };
+
+  // Read-only memory mapping of an archive. Opening does not read the payload, pages
+  // are faulted in from the shared page cache as they are decoded.
+  class MappedArchive
+  {
+  public:
+    // Kernel read-ahead hint for the mapping
+    enum class Access
+    {
+      Normal,
+      Sequential, // aggressive read-ahead, pages behind the reader may be dropped
+      Random      // no read-ahead, for indexed and lazy lookups
+    };
+
+    explicit MappedArchive(const std::string &path, Access access = Access::Normal)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        throw std::runtime_error("Cannot open archive " + path);
+      struct stat st;
+      if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(archive::HeaderSize))
+      {
+        ::close(fd);
+        throw std::runtime_error("Not a serialized archive: " + path);
+      }
+      size_t length = static_cast<size_t>(st.st_size);
+      void *p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (p == MAP_FAILED)
+        throw std::runtime_error("Cannot map archive " + path);
+      mapping = std::make_shared<Mapping>(static_cast<const uint8_t *>(p), length);
+
+      const uint8_t *header = mapping->data;
+      if (std::memcmp(header, archive::Magic, sizeof(archive::Magic)) != 0)
+        throw std::runtime_error("Not a serialized archive: " + path);
+      if (header[8] != archive::Version || header[9] > static_cast<uint8_t>(LengthEncoding::Varint) ||
+          header[10] > static_cast<uint8_t>(IntegerEncoding::Varint) || header[11] == static_cast<uint8_t>(ByteOrder::Native) ||
+          header[11] > static_cast<uint8_t>(ByteOrder::Big))
+        throw std::runtime_error("Unsupported archive header: " + path);
+      fmt.lengths = static_cast<LengthEncoding>(header[9]);
+      fmt.integers = static_cast<IntegerEncoding>(header[10]);
+      fmt.byteOrder = static_cast<ByteOrder>(header[11]);
+      fmt.chunkIndexThreshold = loadFixed<uint32_t>(header + 12, ByteOrder::Little);
+      advise(access);
+    }
+
+    // Payload bytes and the format they were written with
+    const uint8_t *data() const { return mapping->data + archive::HeaderSize; }
+    size_t size() const { return mapping->length - archive::HeaderSize; }
+    const WireFormat &format() const { return fmt; }
+
+    // Deserializer over the payload. It holds the mapping as owner(), so MatView,
+    // Lazy and indexed views stay valid after the MappedArchive is gone.
+    Deserializer reader() const
+    {
+      Deserializer d(data(), size(), mapping);
+      d.setFormat(fmt);
+      return d;
+    }
+
+    void advise(Access access) const
+    {
+      int advice = access == Access::Sequential ? MADV_SEQUENTIAL : access == Access::Random ? MADV_RANDOM : MADV_NORMAL;
+      // Only a hint, failure is harmless
+      ::madvise(const_cast<uint8_t *>(mapping->data), mapping->length, advice);
+    }
+
+    // Asks the kernel to start reading a payload range ahead of its use
+    void prefetch(size_t offset, size_t length) const
+    {
+      if (offset >= size())
+        return;
+      length = std::min(length, size() - offset);
+      size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+      size_t begin = (archive::HeaderSize + offset) / page * page;
+      ::madvise(const_cast<uint8_t *>(mapping->data) + begin, archive::HeaderSize + offset + length - begin, MADV_WILLNEED);
+    }
+
+  private:
+    struct Mapping
+    {
+      Mapping(const uint8_t *data, size_t length) : data(data), length(length) {}
+      ~Mapping() { ::munmap(const_cast<uint8_t *>(data), length); }
+      Mapping(const Mapping &) = delete;
+      Mapping &operator=(const Mapping &) = delete;
+
+      const uint8_t *data;
+      size_t length;
+    };
+
+    std::shared_ptr<const Mapping> mapping;
+    WireFormat fmt;
+  };
+
+} // namespace Serialization
+
+#endif // _WIN32
+
+#endif // _MAPPED_ARCHIVE_HPP_
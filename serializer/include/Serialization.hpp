@@ -5,6 +5,7 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <array>
 #include <set>
 #include <unordered_set>
 #include <string>
@@ -14,6 +15,26 @@
 #include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define SERIALIZATION_HAS_PMR 1
+#endif
+#endif
+
+#include "Sinks.hpp"
+#include "Sources.hpp"
+#include "WireFormat.hpp"
+#include "ByteOrder.hpp"
+#include "Compression.hpp"
+#include "Crc32c.hpp"
 
 // =====================
 // Compatibility helpers
@@ -59,6 +80,9 @@ namespace Serialization
   class Serializer;
   class Deserializer;
 
+  template <typename T>
+  class Lazy;
+
   template <typename T>
   struct always_false : std::false_type {};
 
@@ -69,12 +93,12 @@ namespace Serialization
   template <typename T>
   struct is_map_like<T, void_t<typename T::mapped_type>> : std::true_type {};
 
-  // string detection
+  // string detection, any allocator (std::string, std::pmr::string)
   template <typename T>
   struct is_std_string : std::false_type {};
 
-  template <>
-  struct is_std_string<std::string> : std::true_type {};
+  template <typename Traits, typename Alloc>
+  struct is_std_string<std::basic_string<char, Traits, Alloc>> : std::true_type {};
 
   // push_back detection
   template <typename T, typename = void>
@@ -100,6 +124,102 @@ namespace Serialization
                               decltype(std::declval<T &>().begin()),
                               decltype(std::declval<T &>().end())>> : std::true_type {};
 
+  // =====================
+  // Zero-copy views
+  // =====================
+  // Views returned by Deserializer::read() point into the buffer the Deserializer
+  // was constructed on. They stay valid only while that buffer is alive and
+  // unmodified, and must not outlive it.
+
+  // Read-only view of trivially copyable elements. The bytes are not necessarily
+  // aligned for T, so elements are loaded with memcpy.
+  template <typename T>
+  class Span
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Span: T must be trivially copyable");
+
+  public:
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T *;
+      using reference = T;
+
+      explicit const_iterator(const uint8_t *p) : p(p) {}
+      T operator*() const
+      {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return v;
+      }
+      const_iterator &operator++()
+      {
+        p += sizeof(T);
+        return *this;
+      }
+      bool operator==(const const_iterator &other) const { return p == other.p; }
+      bool operator!=(const const_iterator &other) const { return p != other.p; }
+
+    private:
+      const uint8_t *p;
+    };
+
+    Span() = default;
+    Span(const T *elements, size_t count) : p(reinterpret_cast<const uint8_t *>(elements)), count(count) {}
+
+    // `count` elements stored at possibly unaligned `bytes`
+    static Span fromBytes(const uint8_t *bytes, size_t count)
+    {
+      Span span;
+      span.p = bytes;
+      span.count = count;
+      return span;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const uint8_t *bytes() const { return p; }
+
+    T operator[](size_t i) const { return *const_iterator(p + i * sizeof(T)); }
+
+    // Typed access is only valid when the bytes happen to be aligned for T
+    bool aligned() const { return reinterpret_cast<uintptr_t>(p) % alignof(T) == 0; }
+    const T *data() const { return aligned() ? reinterpret_cast<const T *>(p) : nullptr; }
+
+    const_iterator begin() const { return const_iterator(p); }
+    const_iterator end() const { return const_iterator(p + count * sizeof(T)); }
+
+  private:
+    const uint8_t *p = nullptr;
+    size_t count = 0;
+  };
+
+  // view detection, views have their own read/write paths
+  template <typename T>
+  struct is_view : std::false_type {};
+
+  template <typename T>
+  struct is_view<Span<T>> : std::true_type {};
+
+#if __cplusplus >= 201703L
+  template <>
+  struct is_view<std::string_view> : std::true_type {};
+#endif
+
+  // contiguous storage detection (data() pointing at size() elements)
+  template <typename T, typename = void>
+  struct is_contiguous : std::false_type {};
+
+  template <typename T>
+  struct is_contiguous<T, void_t<
+                              typename T::value_type,
+                              decltype(std::declval<const T &>().data()),
+                              decltype(std::declval<const T &>().size())>>
+      : std::is_same<decltype(std::declval<const T &>().data()), const typename T::value_type *> {};
+
   // custum structure serialization detection
   template <typename T, typename = void>
   struct has_serialize : std::false_type {};
@@ -116,39 +236,452 @@ namespace Serialization
   struct has_deserialize<T, void_t<
                                  decltype(std::declval<T &>().deserialize(std::declval<Deserializer *>()))>> : std::true_type {};
 
+  // Elements that may be copied as raw bytes. Types with their own serialize() or
+  // deserialize() are not. Specialize to std::false_type for a trivially copyable
+  // type whose write<>/read<> is specialized.
+  template <typename T>
+  struct is_bulk_copyable : std::integral_constant<bool, std::is_trivially_copyable<T>::value && !is_view<T>::value &&
+                                                             !has_serialize<T>::value && !has_deserialize<T>::value> {};
+
+  template <typename T, size_t N>
+  struct is_bulk_copyable<std::array<T, N>> : is_bulk_copyable<T> {};
+
+  // Sequences written and read as a length plus one block of element bytes
+  template <typename T, typename = void>
+  struct is_bulk_sequence : std::false_type {};
+
+  template <typename T>
+  struct is_bulk_sequence<T, typename std::enable_if<is_contiguous<T>::value>::type>
+      : is_bulk_copyable<typename T::value_type> {};
+
+  // resize detection
+  template <typename T, typename = void>
+  struct has_resize : std::false_type {};
+
+  template <typename T>
+  struct has_resize<T, void_t<
+                           decltype(std::declval<T &>().resize(std::declval<typename T::size_type>()))>> : std::true_type {};
+
+  // reserve detection (vector, deque-like, unordered containers)
+  template <typename T, typename = void>
+  struct has_reserve : std::false_type {};
+
+  template <typename T>
+  struct has_reserve<T, void_t<
+                            decltype(std::declval<T &>().reserve(std::declval<typename T::size_type>()))>> : std::true_type {};
+
+  // Bulk sequences that can be read with one resize and one memcpy
+  template <typename T>
+  struct is_bulk_resizable : std::integral_constant<bool, is_bulk_sequence<T>::value && has_resize<T>::value> {};
+
+  // Maps and sequences written element by element, which large ones do in chunks
+  template <typename T>
+  struct is_chunked_container
+      : std::integral_constant<bool, is_map_like<T>::value ||
+                                         (!is_std_string<T>::value && !is_tuple_like<T>::value && !is_view<T>::value &&
+                                          has_begin_end<T>::value && !is_bulk_sequence<T>::value)> {};
+
+  // get_allocator detection
+  template <typename T, typename = void>
+  struct has_get_allocator : std::false_type {};
+
+  template <typename T>
+  struct has_get_allocator<T, void_t<decltype(std::declval<const T &>().get_allocator())>> : std::true_type {};
+
+  // emplace_back() of an empty element and back() returning a real reference, not a
+  // proxy like std::vector<bool>
+  template <typename T, typename = void>
+  struct has_emplace_back : std::false_type {};
+
+  template <typename T>
+  struct has_emplace_back<T, void_t<decltype(std::declval<T &>().emplace_back()), decltype(std::declval<T &>().back())>>
+      : std::is_same<decltype(std::declval<T &>().back()), typename T::value_type &> {};
+
+  // =====================
+  // Allocator propagation
+  // =====================
+  // Values decoded for a container are constructed with its allocator (uses-allocator
+  // construction), so nested pmr strings and containers share its memory resource.
+  template <typename V, typename Alloc>
+  typename std::enable_if<std::uses_allocator<V, Alloc>::value &&
+                              std::is_constructible<V, std::allocator_arg_t, const Alloc &>::value,
+                          V>::type
+  makeWithAllocator(const Alloc &alloc)
+  {
+    return V(std::allocator_arg, alloc);
+  }
+
+  template <typename V, typename Alloc>
+  typename std::enable_if<std::uses_allocator<V, Alloc>::value &&
+                              !std::is_constructible<V, std::allocator_arg_t, const Alloc &>::value,
+                          V>::type
+  makeWithAllocator(const Alloc &alloc)
+  {
+    return V(alloc);
+  }
+
+  template <typename V, typename Alloc>
+  typename std::enable_if<!std::uses_allocator<V, Alloc>::value, V>::type
+  makeWithAllocator(const Alloc &)
+  {
+    return V();
+  }
+
+  template <typename V, typename C>
+  typename std::enable_if<has_get_allocator<C>::value, V>::type
+  makeElement(const C &c)
+  {
+    return makeWithAllocator<V>(c.get_allocator());
+  }
+
+  template <typename V, typename C>
+  typename std::enable_if<!has_get_allocator<C>::value, V>::type
+  makeElement(const C &)
+  {
+    return V();
+  }
+
+  // construct-from-stream detection: static T construct(Deserializer *)
+  template <typename T, typename = void>
+  struct has_construct : std::false_type {};
+
+  template <typename T>
+  struct has_construct<T, void_t<decltype(T::construct(std::declval<Deserializer *>()))>>
+      : std::is_same<decltype(T::construct(std::declval<Deserializer *>())), T> {};
+
+  // node handle detection (C++17 associative and unordered containers)
+  template <typename T, typename = void>
+  struct has_node_handles : std::false_type {};
+
+#if __cplusplus >= 201703L
+  template <typename T>
+  struct has_node_handles<T, void_t<typename T::node_type,
+                                    decltype(std::declval<T &>().extract(std::declval<T &>().begin()))>> : std::true_type {};
+#endif
+
+  // Containers using std::allocator, whose chunks can be decoded into separate containers
+  template <typename T, typename = void>
+  struct has_default_allocator : std::false_type {};
+
+  template <typename T>
+  struct has_default_allocator<T, void_t<typename T::allocator_type>>
+      : std::is_same<typename T::allocator_type, std::allocator<typename T::value_type>> {};
+
+  // Values that Deserializer::read<T>() builds directly instead of reading into an empty one
+  template <typename T>
+  struct is_constructed : std::integral_constant<bool, has_construct<T>::value || !std::is_default_constructible<T>::value> {};
+
+  // Exact number of bytes Serializer::write() produces for a value
+  template <typename T>
+  size_t serializedSize(const T &value, const WireFormat &format);
+
+  template <typename T>
+  size_t serializedSize(const T &value);
+
+  // Parallel encoding and decoding of large containers, see Serializer::setParallel()
+  // and Deserializer::setParallel()
+  struct ParallelOptions
+  {
+    // Sequences and maps with fewer elements are written sequentially
+    size_t threshold = 16 * 1024;
+    // Elements encoded per task
+    size_t chunkSize = 2048;
+    // Worker threads, 0 uses the hardware concurrency
+    unsigned threads = 0;
+  };
+
   // =====================
   // Serializer
   // =====================
   class Serializer
   {
   private:
-    std::vector<uint8_t> buffer;
+    VectorSink buffer;
+    Sink *sink = &buffer;
+    WireFormat fmt;
+    bool parallel = false;
+    ParallelOptions parallelOptions;
+    // Threads of parallel writes, started by the first one and reused by the rest.
+    // Copies start their own.
+    std::unique_ptr<WorkerPool> workers;
+
+    // Size pre-pass: a measuring Serializer runs the same dispatch but only counts bytes
+    bool measuring = false;
+    size_t measured = 0;
+    // Nesting level of write() calls, top-level writes reserve their exact size up front
+    size_t depth = 0;
+
+    // Running checksum: bytes before checksumFrom in the sink window are already folded
+    // into checksum, the rest is folded in before the sink may move or hand them off
+    bool checksumming = false;
+    uint32_t checksum = 0;
+    const uint8_t *checksumFrom = nullptr;
+
+    struct measure_tag {};
+    explicit Serializer(measure_tag) : measuring(true) {}
+
+    template <typename T>
+    friend size_t serializedSize(const T &value, const WireFormat &format);
+
+    template <typename T>
+    friend class Lazy;
+
+    struct DepthGuard
+    {
+      size_t &depth;
+      explicit DepthGuard(size_t &d) : depth(d) { ++depth; }
+      ~DepthGuard() { --depth; }
+    };
+
+    // Reserve room for a top-level value so it is written without reallocation
+    template <typename T>
+    void presize(const T &value)
+    {
+      // A container encoded in parallel sizes its output chunk by chunk instead
+      if (measuring || depth != 0 || !sink->sizeHints || is_bulk_copyable<T>::value || chunkedInParallel(value))
+        return;
+      reserveAhead(serializedSize(value, fmt));
+    }
+
+    template <typename T>
+    typename std::enable_if<is_chunked_container<T>::value, bool>::type chunkedInParallel(const T &value) const
+    {
+      return parallelFits(value.size());
+    }
+
+    template <typename T>
+    typename std::enable_if<!is_chunked_container<T>::value, bool>::type chunkedInParallel(const T &) const
+    {
+      return false;
+    }
+
+    // Writes a value whose size `n` was just measured. A measuring Serializer only
+    // counts it, measuring it again would double the work at every nesting level.
+    template <typename T>
+    void writeMeasured(const T &value, size_t n)
+    {
+      if (measuring)
+        measured += n;
+      else
+        write(value);
+    }
+
+    void reserveAhead(size_t n)
+    {
+      // Room for a pending trailer too, so writing it does not regrow the buffer
+      n += checksumming ? ChecksumSize : 0;
+      foldChecksum();
+      sink->reserve(n);
+      checksumFrom = sink->cur;
+    }
+
+    void foldChecksum()
+    {
+      if (checksumming)
+      {
+        checksum = crc32c(checksumFrom, static_cast<size_t>(sink->cur - checksumFrom), checksum);
+        checksumFrom = sink->cur;
+      }
+    }
+
+    // Raw bytes
+    void writeBytes(const void *p, size_t n)
+    {
+      if (measuring)
+      {
+        measured += n;
+        return;
+      }
+      if (n == 0)
+        return;
+      if (static_cast<size_t>(sink->end - sink->cur) >= n)
+      {
+        std::memcpy(sink->cur, p, n);
+        sink->cur += n;
+      }
+      else
+      {
+        foldChecksum();
+        sink->overflow(static_cast<const uint8_t *>(p), n);
+        if (checksumming)
+        {
+          checksum = crc32c(p, n, checksum);
+          checksumFrom = sink->cur;
+        }
+      }
+    }
+
+    // Large contiguous payload, gathering sinks keep a reference instead of a copy
+    void writeBlob(const void *p, size_t n)
+    {
+      if (!measuring && n != 0 && n >= sink->referenceThreshold)
+      {
+        foldChecksum();
+        if (sink->reference(static_cast<const uint8_t *>(p), n))
+        {
+          if (checksumming)
+          {
+            checksum = crc32c(p, n, checksum);
+            checksumFrom = sink->cur;
+          }
+          return;
+        }
+      }
+      writeBytes(p, n);
+    }
+
+    void writeVarint(uint64_t v)
+    {
+      uint8_t tmp[MaxVarintSize];
+      writeBytes(tmp, encodeVarint(v, tmp));
+    }
+
+    // Fixed-width scalar in the wire byte order
+    template <typename T>
+    void writeFixed(const T &value)
+    {
+      if (size_t width = swapWidth<T>(fmt.byteOrder))
+      {
+        uint8_t tmp[sizeof(T)];
+        swapCopyScalar(tmp, reinterpret_cast<const uint8_t *>(&value), sizeof(T) / width, width);
+        writeBytes(tmp, sizeof(T));
+      }
+      else
+        writeBytes(&value, sizeof(T));
+    }
+
+    // `count` elements of `width` bytes, byte swapped on the way into the sink window
+    void writeSwapped(const void *p, size_t count, size_t width)
+    {
+      if (measuring)
+      {
+        measured += count * width;
+        return;
+      }
+      const uint8_t *src = static_cast<const uint8_t *>(p);
+      if (static_cast<size_t>(sink->end - sink->cur) >= count * width)
+      {
+        swapCopy(sink->cur, src, count, width);
+        sink->cur += count * width;
+        return;
+      }
+      uint8_t tmp[4096];
+      size_t perChunk = sizeof(tmp) / width;
+      while (count > 0)
+      {
+        size_t n = std::min(count, perChunk);
+        swapCopy(tmp, src, n, width);
+        writeBytes(tmp, n * width);
+        src += n * width;
+        count -= n;
+      }
+    }
+
+    // Offset of an indexed encoding, 4 or 8 bytes wide
+    void writeOffset(uint64_t v, uint8_t width)
+    {
+      if (width == 4)
+        writeFixed(static_cast<uint32_t>(v));
+      else
+        writeFixed(v);
+    }
+
+    // Length prefix of strings, sequences and maps
+    void writeLength(uint64_t len)
+    {
+      if (fmt.lengths == LengthEncoding::Varint)
+        writeVarint(len);
+      else
+        writeFixed(len);
+    }
 
     // POD
     template <typename T>
-    void writePod(const T &value)
+    typename std::enable_if<!is_varint_integer<T>::value>::type
+    writePod(const T &value)
     {
       static_assert(std::is_trivially_copyable<T>::value, "writePod: T must be trivially copyable");
-      const uint8_t *p = reinterpret_cast<const uint8_t *>(&value);
-      buffer.insert(buffer.end(), p, p + sizeof(T));
+      writeFixed(value);
+    }
+
+    // Integers, zigzag encoded when signed and written as varints
+    template <typename T>
+    typename std::enable_if<is_varint_integer<T>::value>::type
+    writePod(const T &value)
+    {
+      if (fmt.integers == IntegerEncoding::Varint)
+        writeVarint(std::is_signed<T>::value ? zigzagEncode(static_cast<int64_t>(value)) : static_cast<uint64_t>(value));
+      else
+        writeFixed(value);
+    }
+
+    // Trivially copyable elements, possibly unaligned. One block copy when their wire
+    // form is their memory, one vectorized swap when only the byte order differs.
+    template <typename T>
+    void writeElements(const void *p, size_t count)
+    {
+      if (is_varint_integer<T>::value && fmt.integers == IntegerEncoding::Varint)
+      {
+        const uint8_t *src = static_cast<const uint8_t *>(p);
+        for (size_t i = 0; i < count; ++i, src += sizeof(T))
+        {
+          T v;
+          std::memcpy(&v, src, sizeof(T));
+          writePod(v);
+        }
+      }
+      else if (size_t width = swapWidth<T>(fmt.byteOrder))
+        writeSwapped(p, count * sizeof(T) / width, width);
+      else
+        writeBlob(p, count * sizeof(T));
     }
 
     // String
-    void writeString(const std::string &s)
+    template <typename String>
+    void writeString(const String &s)
+    {
+      writeLength(s.size());
+      writeBlob(s.data(), s.size());
+    }
+
+    // Views, same wire format as std::string and bulk sequences
+    template <typename T>
+    void writeSpan(const Span<T> &span)
+    {
+      writeLength(span.size());
+      writeElements<T>(span.bytes(), span.size());
+    }
+
+#if __cplusplus >= 201703L
+    void writeStringView(std::string_view s)
     {
-      uint64_t len = s.size();
-      writePod(len);
-      buffer.insert(buffer.end(),
-                    reinterpret_cast<const uint8_t *>(s.data()),
-                    reinterpret_cast<const uint8_t *>(s.data()) + len);
+      writeLength(s.size());
+      writeBlob(s.data(), s.size());
     }
+#endif
 
     // Sequence-like
+    // Contiguous trivially copyable elements: length and one bulk copy
+    template <typename Seq>
+    typename std::enable_if<is_bulk_sequence<Seq>::value>::type
+    writeSequenceLike(const Seq &seq)
+    {
+      writeLength(seq.size());
+      writeElements<typename Seq::value_type>(seq.data(), seq.size());
+    }
+
+    // Element by element
     template <typename Seq>
-    void writeSequenceLike(const Seq &seq)
+    typename std::enable_if<!is_bulk_sequence<Seq>::value>::type
+    writeSequenceLike(const Seq &seq)
     {
-      uint64_t len = seq.size();
-      writePod(len);
+      writeLength(seq.size());
+      if (chunkIndexFits(seq.size()) || parallelFits(seq.size()))
+      {
+        writeChunks(seq.begin(), seq.size(), [](Serializer &s, typename Seq::const_iterator it)
+                    { s.write(*it); });
+        return;
+      }
       for (const auto &v : seq)
         write(v);
     }
@@ -172,8 +705,16 @@ namespace Serialization
     template <typename Map>
     void writeMapLike(const Map &map)
     {
-      uint64_t len = map.size();
-      writePod(len);
+      writeLength(map.size());
+      if (chunkIndexFits(map.size()) || parallelFits(map.size()))
+      {
+        writeChunks(map.begin(), map.size(), [](Serializer &s, typename Map::const_iterator it)
+                    {
+                      s.write(it->first);
+                      s.write(it->second);
+                    });
+        return;
+      }
       for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
       {
         write(it->first);
@@ -181,6 +722,142 @@ namespace Serialization
       }
     }
 
+    bool parallelFits(size_t count) const
+    {
+      return parallel && !measuring && count >= parallelOptions.threshold && count > 1;
+    }
+
+    // Containers that carry a chunk index in the current format (see WireFormat)
+    bool chunkIndexFits(size_t count) const
+    {
+      return fmt.chunkIndexThreshold != 0 && count >= fmt.chunkIndexThreshold;
+    }
+
+    // Writes `count` elements from `first` in chunks, preceded by the chunk index when
+    // the format asks for one. Indexed chunks have the format's chunkElements, others
+    // parallelOptions.chunkSize.
+    //
+    // In parallel, every chunk's size is measured, the chunks get disjoint ranges of
+    // the sink window and are encoded into them concurrently. Sinks without size hints
+    // get each chunk in its own buffer instead, written out in order. Elements are
+    // encoded independently, so the bytes match a sequential write.
+    template <typename It, typename WriteOne>
+    void writeChunks(It first, size_t count, WriteOne writeOne)
+    {
+      const bool index = chunkIndexFits(count);
+      const size_t chunkSize = std::max<size_t>(index ? fmt.chunkElements : parallelOptions.chunkSize, 1);
+      const size_t chunks = (count - 1) / chunkSize + 1;
+      std::vector<It> starts;
+      starts.reserve(chunks + 1);
+      for (size_t c = 0; c < chunks; ++c)
+      {
+        starts.push_back(first);
+        std::advance(first, std::min(chunkSize, count - c * chunkSize));
+      }
+      starts.push_back(first);
+
+      const bool concurrent = parallelFits(count);
+      const unsigned threads = concurrent ? workerPool().threads() : 1;
+      // Chunk serializers skip the per-value size pre-pass
+      auto encode = [&](Serializer &s, size_t c)
+      {
+        s.fmt = fmt;
+        DepthGuard guard(s.depth);
+        for (It it = starts[c]; it != starts[c + 1]; ++it)
+          writeOne(s, it);
+      };
+
+      if (index)
+        writeLength(chunkSize);
+      if (measuring)
+      {
+        measured += chunks * sizeof(uint64_t);
+        for (size_t c = 0; c < chunks; ++c)
+          encode(*this, c);
+        return;
+      }
+
+      std::vector<size_t> offsets;
+      if (index || sink->sizeHints)
+      {
+        offsets.assign(chunks + 1, 0);
+        forEachChunk(concurrent, chunks, [&](size_t c)
+                    {
+                      Serializer m{measure_tag{}};
+                      encode(m, c);
+                      offsets[c + 1] = m.measured;
+                    });
+        for (size_t c = 0; c < chunks; ++c)
+        {
+          if (index)
+            writeFixed(static_cast<uint64_t>(offsets[c + 1]));
+          offsets[c + 1] += offsets[c];
+        }
+      }
+      if (!concurrent)
+      {
+        for (size_t c = 0; c < chunks; ++c)
+          encode(*this, c);
+        return;
+      }
+
+      if (sink->sizeHints)
+      {
+        const size_t total = offsets[chunks];
+        foldChecksum();
+        sink->reserve(total);
+        checksumFrom = sink->cur;
+        if (static_cast<size_t>(sink->end - sink->cur) < total)
+          throw std::runtime_error("Sink did not reserve the requested size");
+        uint8_t *base = sink->cur;
+        forEachChunk(true, chunks, [&](size_t c)
+                    {
+                      SpanSink out(base + offsets[c], offsets[c + 1] - offsets[c]);
+                      Serializer s(out);
+                      encode(s, c);
+                    });
+        sink->cur += total;
+        return;
+      }
+
+      // Rounds of chunks bound the staging memory
+      const size_t round = static_cast<size_t>(threads) * 4;
+      std::vector<std::vector<uint8_t>> staged(std::min(round, chunks));
+      for (size_t r = 0; r < chunks; r += round)
+      {
+        const size_t n = std::min(round, chunks - r);
+        forEachChunk(true, n, [&](size_t c)
+                    {
+                      Serializer s(std::move(staged[c]));
+                      encode(s, r + c);
+                      staged[c] = s.release();
+                    });
+        for (size_t c = 0; c < n; ++c)
+          writeBytes(staged[c].data(), staged[c].size());
+      }
+    }
+
+    WorkerPool &workerPool()
+    {
+      unsigned threads = parallelOptions.threads ? parallelOptions.threads : std::max(1u, std::thread::hardware_concurrency());
+      if (!workers || workers->threads() != threads)
+        workers.reset(new WorkerPool(threads));
+      return *workers;
+    }
+
+    // Runs fn(c) for every chunk, on the worker pool when `concurrent`
+    template <typename Fn>
+    void forEachChunk(bool concurrent, size_t chunks, Fn fn)
+    {
+      if (concurrent)
+      {
+        workerPool().run(chunks, fn);
+        return;
+      }
+      for (size_t c = 0; c < chunks; ++c)
+        fn(c);
+    }
+
     // Custom structure serialization
     template <typename T>
     void writeCustom(const T &obj)
@@ -201,7 +878,8 @@ namespace Serialization
     };
 
     template <typename T>
-    struct write_helper<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+    struct write_helper<T, typename std::enable_if<std::is_trivially_copyable<T>::value && !is_view<T>::value && !has_serialize<T>::value &&
+                                                   (!is_tuple_like<T>::value || is_bulk_copyable<T>::value)>::type>
     {
       static void apply(Serializer &s, const T &v) { s.writePod(v); }
     };
@@ -218,8 +896,10 @@ namespace Serialization
       static void apply(Serializer &s, const T &v) { s.writeMapLike(v); }
     };
 
+    // Also arrays of custom elements, which are trivially copyable themselves
     template <typename T>
-    struct write_helper<T, typename std::enable_if<is_tuple_like<T>::value>::type>
+    struct write_helper<T, typename std::enable_if<is_tuple_like<T>::value && !is_bulk_copyable<T>::value &&
+                                                   !has_serialize<T>::value>::type>
     {
       static void apply(Serializer &s, const T &v) { s.writeTupleLike(v); }
     };
@@ -227,11 +907,27 @@ namespace Serialization
     template <typename T>
     struct write_helper<T, typename std::enable_if<!is_map_like<T>::value &&
                                                    !is_std_string<T>::value &&
+                                                   !is_tuple_like<T>::value &&
+                                                   !is_view<T>::value &&
                                                    has_begin_end<T>::value>::type>
     {
       static void apply(Serializer &s, const T &v) { s.writeSequenceLike(v); }
     };
 
+    template <typename T>
+    struct write_helper<Span<T>>
+    {
+      static void apply(Serializer &s, const Span<T> &v) { s.writeSpan(v); }
+    };
+
+#if __cplusplus >= 201703L
+    template <typename T>
+    struct write_helper<T, typename std::enable_if<std::is_same<T, std::string_view>::value>::type>
+    {
+      static void apply(Serializer &s, const T &v) { s.writeStringView(v); }
+    };
+#endif
+
     template <typename T>
     struct write_helper<T, typename std::enable_if<has_serialize<T>::value>::type>
     {
@@ -239,13 +935,199 @@ namespace Serialization
     };
 
   public:
-    template <typename T>
-    void write(const T &value)
+    Serializer() = default;
+
+    // Adopt caller-owned storage: its capacity is reused, its contents are discarded
+    explicit Serializer(std::vector<uint8_t> &&storage) : buffer(std::move(storage)) {}
+
+    // Write into an external sink instead of the internal buffer, the sink must outlive the Serializer
+    explicit Serializer(Sink &out) : sink(&out) {}
+
+    Serializer(const Serializer &other)
+        : buffer(other.buffer), sink(other.sink == &other.buffer ? &buffer : other.sink), fmt(other.fmt),
+          parallel(other.parallel), parallelOptions(other.parallelOptions) {}
+
+    Serializer(Serializer &&other) noexcept
+        : buffer(std::move(other.buffer)), sink(other.sink == &other.buffer ? &buffer : other.sink), fmt(other.fmt),
+          parallel(other.parallel), parallelOptions(other.parallelOptions), workers(std::move(other.workers)) {}
+
+    Serializer &operator=(const Serializer &other)
     {
-      write_helper<T>::apply(*this, value);
+      buffer = other.buffer;
+      sink = other.sink == &other.buffer ? &buffer : other.sink;
+      fmt = other.fmt;
+      parallel = other.parallel;
+      parallelOptions = other.parallelOptions;
+      return *this;
     }
 
-    const uint8_t* data() const
+    Serializer &operator=(Serializer &&other) noexcept
+    {
+      buffer = std::move(other.buffer);
+      sink = other.sink == &other.buffer ? &buffer : other.sink;
+      fmt = other.fmt;
+      parallel = other.parallel;
+      parallelOptions = other.parallelOptions;
+      workers = std::move(other.workers);
+      return *this;
+    }
+
+    template <typename T>
+    void write(const T &value)
+    {
+      presize(value);
+      DepthGuard guard(depth);
+      write_helper<T>::apply(*this, value);
+    }
+
+    // =====================
+    // Tagged fields
+    // =====================
+    // Opt-in schema-evolvable encoding for custom types: every field is written as a
+    // varint tag, a varint byte length and the value, and endFields() closes the struct.
+    // Readers skip unknown fields without decoding them (see Deserializer::readFields).
+    // Tags must be non-zero and are always varints, whatever the WireFormat.
+    template <typename T>
+    void writeField(uint32_t tag, const T &value)
+    {
+      if (tag == 0)
+        throw std::invalid_argument("Field tag 0 is reserved");
+      writeVarint(tag);
+      size_t n = serializedSize(value, fmt);
+      writeVarint(n);
+      writeMeasured(value, n);
+    }
+
+    void endFields()
+    {
+      writeVarint(0);
+    }
+
+    // Length-prefixed frame [payload length][value], decoded incrementally by FrameDecoder
+    template <typename T>
+    void writeFrame(const T &value)
+    {
+      size_t n = serializedSize(value, fmt);
+      writeLength(n);
+      if (!measuring && depth == 0 && sink->sizeHints)
+        reserveAhead(n);
+      // Inside the guard write() does not size the value a second time
+      DepthGuard guard(depth);
+      writeMeasured(value, n);
+    }
+
+    // Random-access container encodings, defined in Indexed.hpp
+    template <typename Seq>
+    void writeIndexedSequence(const Seq &seq);
+
+    template <typename Map>
+    void writeIndexedMap(const Map &map);
+
+    // Appends bytes that are already encoded in this Serializer's format
+    void writeRaw(const void *p, size_t n)
+    {
+      writeBytes(p, n);
+    }
+
+    // Compressed frame: [raw size][block size][blocks], read with Deserializer::readCompressed.
+    // Payloads below options.threshold are stored with block size 0 and written as is,
+    // otherwise every block is [length][bytes] and a length equal to the raw block size
+    // marks a block stored uncompressed. Blocks are compressed in parallel.
+    void writeCompressed(const uint8_t *p, size_t n, const CompressionOptions &options = CompressionOptions())
+    {
+      writeLength(n);
+      if (n < options.threshold || n == 0 || options.blockSize == 0)
+      {
+        writeLength(0);
+        writeBytes(p, n);
+        return;
+      }
+
+      const size_t blockSize = options.blockSize;
+      const size_t blocks = (n - 1) / blockSize + 1;
+      std::vector<std::vector<uint8_t>> packed(blocks);
+      parallelFor(blocks, options.threads, [&](size_t b)
+                  {
+                    size_t len = std::min(blockSize, n - b * blockSize);
+                    std::vector<uint8_t> &out = packed[b];
+                    out.resize(compressBound(len));
+                    size_t compressed = compressBlock(p + b * blockSize, len, out.data());
+                    // Left empty when compression does not pay off
+                    out.resize(compressed < len ? compressed : 0);
+                  });
+
+      writeLength(blockSize);
+      for (size_t b = 0; b < blocks; ++b)
+      {
+        if (packed[b].empty())
+        {
+          size_t len = std::min(blockSize, n - b * blockSize);
+          writeLength(len);
+          writeBytes(p + b * blockSize, len);
+        }
+        else
+        {
+          writeLength(packed[b].size());
+          writeBytes(packed[b].data(), packed[b].size());
+        }
+      }
+    }
+
+    // Wire format of the following writes, readers must use the same one
+    void setFormat(const WireFormat &format)
+    {
+      fmt = format;
+    }
+
+    // Opt-in: sequences and maps of at least options.threshold elements that are not
+    // written as one block are encoded on a thread pool, started by the first such
+    // write and kept until the Serializer is destroyed or the thread count changes. The output is byte-identical
+    // to a sequential write. Element serialize() calls then run concurrently on
+    // separate Serializers, so they must not share mutable state.
+    void setParallel(bool enable, const ParallelOptions &options = ParallelOptions())
+    {
+      parallel = enable;
+      parallelOptions = options;
+    }
+
+    const WireFormat &format() const
+    {
+      return fmt;
+    }
+
+    // =====================
+    // Integrity trailer
+    // =====================
+    // beginChecksum() starts a CRC32C over the following writes and writeChecksum()
+    // appends it as a 4 byte trailer in the wire byte order. The checksum is folded in
+    // as the sink window fills, so streaming sinks are covered without a second pass.
+    void beginChecksum()
+    {
+      checksumming = true;
+      checksum = 0;
+      checksumFrom = sink->cur;
+    }
+
+    // Returns the written checksum
+    uint32_t writeChecksum()
+    {
+      foldChecksum();
+      checksumming = false;
+      uint32_t value = checksum;
+      writeFixed(value);
+      return value;
+    }
+
+    // Push bytes buffered by the sink to their destination
+    void flush()
+    {
+      foldChecksum();
+      sink->flush();
+      checksumFrom = sink->cur;
+    }
+
+    // data(), dataLength(), capacity(), reset() and release() refer to the internal buffer
+    const uint8_t* data() const
     {
       return buffer.data();
     }
@@ -254,8 +1136,50 @@ namespace Serialization
     {
       return buffer.size();
     }
+
+    size_t capacity() const
+    {
+      return buffer.capacity();
+    }
+
+    // Discard the written data but keep the allocated capacity for the next message
+    void reset()
+    {
+      buffer.clear();
+      checksumming = false;
+    }
+
+    // Hand over the written data, the Serializer is left empty
+    std::vector<uint8_t> release()
+    {
+      checksumming = false;
+      return buffer.release();
+    }
   };
 
+  template <typename T>
+  size_t serializedSize(const T &value, const WireFormat &format)
+  {
+    Serializer s{Serializer::measure_tag{}};
+    s.fmt = format;
+    s.write(value);
+    return s.measured;
+  }
+
+  template <typename T>
+  size_t serializedSize(const T &value)
+  {
+    return serializedSize(value, WireFormat());
+  }
+
+  // Checks a whole message that ends with a checksum trailer before decoding any of it
+  inline bool hasValidChecksum(const uint8_t *p, size_t n, ByteOrder order = ByteOrder::Native)
+  {
+    if (n < ChecksumSize)
+      return false;
+    return loadFixed<uint32_t>(p + n - ChecksumSize, order) == crc32c(p, n - ChecksumSize);
+  }
+
   // =====================
   // Deserializer
   // =====================
@@ -268,61 +1192,561 @@ namespace Serialization
     explicit Deserializer(const uint8_t* buf, size_t length)
         : data(buf), size(length) {}
 
-    // POD
+    // Shares ownership of the input so zero-copy results can keep it alive
+    explicit Deserializer(std::shared_ptr<const std::vector<uint8_t>> buf)
+        : data(buf->data()), size(buf->size()), keepAlive(std::move(buf)) {}
+
+    Deserializer(const uint8_t *buf, size_t length, std::shared_ptr<const void> owner)
+        : data(buf), size(length), keepAlive(std::move(owner)) {}
+
+    // Streams from `in` through a window of `windowSize` bytes. Zero-copy views (Span,
+    // string_view, zero-copy Mat) need an in-memory input and throw; Lazy, Compressed
+    // and indexed fields keep a copy of their bytes.
+    explicit Deserializer(Source &in, size_t windowSize = 64 * 1024)
+        : data(nullptr), source(&in), window(std::make_shared<std::vector<uint8_t>>(std::max<size_t>(windowSize, MaxVarintSize))),
+          windowSize(window->size()), streamed(true)
+    {
+      data = window->data();
+    }
+
+    // Keep-alive handle of the input buffer, empty when the caller manages its lifetime
+    const std::shared_ptr<const void> &owner() const
+    {
+      return keepAlive;
+    }
+
+    // Opt-in: cv::Mat reads wrap the input buffer instead of copying it when the pixels
+    // are aligned for the element type. Such a Mat does not own its pixels, so the input
+    // buffer must outlive it (see MatView for a version that holds owner()).
+    void setZeroCopy(bool enable)
+    {
+      zeroCopy = enable;
+    }
+
+    // Opt-in: sequences, sets and maps are decoded over their existing contents instead
+    // of being cleared first. Elements keep their capacity and map/set nodes are
+    // recycled, so decoding same-shaped messages into the same objects stops allocating.
+    void setReuse(bool enable)
+    {
+      reuse = enable;
+    }
+
+    // Opt-in: containers written with a chunk index (WireFormat::chunkIndexThreshold)
+    // are decoded one chunk per task on options.threads threads. The index decides
+    // which containers are split and where, so threshold and chunkSize only apply to
+    // writes. Applies to in-memory input and containers with the default allocator,
+    // others are read sequentially. Reuse mode reads sequentially too.
+    void setParallel(bool enable, const ParallelOptions &options = ParallelOptions())
+    {
+      parallel = enable;
+      parallelOptions = options;
+    }
+
+    // Streams only: the largest buffer allocated up front from a length in the input
+    // (cv::Mat pixels, a decompressed frame, the window grown by readRaw()). Larger
+    // lengths throw instead of reserving memory the source may never supply.
+    void setMaxAllocation(uint64_t bytes)
+    {
+      maxAllocation = bytes;
+    }
+
+#if defined(SERIALIZATION_HAS_PMR)
+    // Memory resource, e.g. a std::pmr::monotonic_buffer_resource arena, for the values
+    // built by make(). Elements decoded into a container always use that container's
+    // allocator, so a pmr value made here keeps its whole tree in the arena.
+    void setMemoryResource(std::pmr::memory_resource *resource)
+    {
+      memory = resource;
+    }
+
+    std::pmr::memory_resource *memoryResource() const
+    {
+      return memory ? memory : std::pmr::get_default_resource();
+    }
+
+    // Empty T bound to memoryResource() when T is allocator-aware:
+    //   auto names = d.make<std::pmr::vector<std::pmr::string>>(); d.read(names);
     template <typename T>
-    void readPod(T &value)
+    T make() const
     {
-      static_assert(std::is_trivially_copyable<T>::value, "readPod: T must be trivially copyable");
-      if (pos + sizeof(T) > size)
+      return makeWithAllocator<T>(std::pmr::polymorphic_allocator<char>(memoryResource()));
+    }
+#endif
+
+    // Wire format the input was written with
+    void setFormat(const WireFormat &format)
+    {
+      fmt = format;
+    }
+
+    const WireFormat &format() const
+    {
+      return fmt;
+    }
+
+    // Skips `n` bytes and returns a pointer to them in the input buffer. When streaming
+    // the pointer is only valid until the next read, and the window grows to `n` bytes
+    // until then.
+    const uint8_t *readRaw(uint64_t n)
+    {
+      require(n);
+      const uint8_t *p = data + pos;
+      pos += static_cast<size_t>(n);
+      return p;
+    }
+
+    // Like readRaw(), but the bytes stay valid while `holder` is kept: it is set to
+    // owner() for an in-memory input, and to a copy of the bytes when streaming
+    const uint8_t *readShared(uint64_t n, std::shared_ptr<const void> &holder)
+    {
+      if (!streamed)
+      {
+        holder = keepAlive;
+        return readRaw(n);
+      }
+      auto copy = std::make_shared<std::vector<uint8_t>>();
+      readChunked(*copy, n);
+      holder = copy;
+      return copy->data();
+    }
+
+    // Copies `n` input bytes to `dst`, a stream reads what is not buffered straight
+    // from the source
+    void readBytes(void *dst, size_t n)
+    {
+      uint8_t *out = static_cast<uint8_t *>(dst);
+      size_t buffered = std::min(n, size - pos);
+      if (buffered < n && !source)
+        throw std::runtime_error("Buffer underflow");
+      if (buffered)
+        std::memcpy(out, data + pos, buffered);
+      pos += buffered;
+      out += buffered;
+      n -= buffered;
+      if (n == 0)
+        return;
+      // Small remainders go through the window, so the source sees large reads only
+      if (n < window->size() / 2)
+      {
+        require(n);
+        std::memcpy(out, data + pos, n);
+        pos += n;
+        return;
+      }
+      foldChecksum();
+      for (size_t left = n; left > 0;)
+      {
+        size_t got = source->read(out + (n - left), left);
+        if (got == 0)
+          throw std::runtime_error("Buffer underflow");
+        left -= got;
+      }
+      if (checksumming)
+        checksum = crc32c(out, n, checksum);
+    }
+
+    // Marks the start of the bytes covered by the next verifyChecksum()
+    void beginChecksum()
+    {
+      checksumStart = pos;
+      checksum = 0;
+      checksumming = true;
+    }
+
+    // Reads the trailer written by Serializer::writeChecksum() and throws when it does
+    // not match the bytes read since beginChecksum()
+    void verifyChecksum()
+    {
+      uint32_t expected = crc32c(data + checksumStart, pos - checksumStart, checksum);
+      checksumming = false;
+      uint32_t stored;
+      readFixed(stored);
+      if (stored != expected)
+        throw std::runtime_error("Checksum mismatch");
+    }
+
+    // Bytes left in the input, for a stream the bytes left in its window
+    size_t remaining() const
+    {
+      return size - pos;
+    }
+
+    // Reads a frame written by Serializer::writeCompressed and returns a Deserializer
+    // over the decompressed bytes with this one's format and zero-copy setting.
+    // Blocks are decompressed in parallel, `threads` as in CompressionOptions.
+    Deserializer readCompressed(unsigned threads = 0)
+    {
+      uint64_t rawSize = readLength();
+      uint64_t blockSize = readLength();
+      // Blocks are never larger than their raw bytes, so this bounds the copy too
+      checkAllocation(rawSize);
+      if (blockSize == 0)
+      {
+        std::shared_ptr<const void> holder;
+        const uint8_t *p = readShared(rawSize, holder);
+        return inner(p, static_cast<size_t>(rawSize), std::move(holder));
+      }
+
+      // Every block has at least a one byte length
+      uint64_t blocks = rawSize == 0 ? 0 : (rawSize - 1) / blockSize + 1;
+      if (!source && blocks > size - pos)
+        throw std::runtime_error("Malformed compressed frame");
+      // Block offsets from `base`: the input buffer, or a copy of the blocks when
+      // streaming since the window moves on
+      std::vector<uint8_t> held;
+      std::vector<std::pair<size_t, size_t>> stored;
+      stored.reserve(static_cast<size_t>(std::min<uint64_t>(blocks, size - pos)));
+      for (uint64_t b = 0; b < blocks; ++b)
+      {
+        uint64_t len = readLength();
+        uint64_t rawLength = std::min(blockSize, rawSize - b * blockSize);
+        // Bounds the allocation below, a sequence expands less than 256 times
+        if (len > rawLength || rawLength / 256 > len)
+          throw std::runtime_error("Malformed compressed frame");
+        if (!source)
+        {
+          const uint8_t *p = readRaw(len);
+          stored.emplace_back(static_cast<size_t>(p - data), static_cast<size_t>(len));
+          continue;
+        }
+        stored.emplace_back(held.size(), static_cast<size_t>(len));
+        held.resize(held.size() + static_cast<size_t>(len));
+        readBytes(held.data() + stored.back().first, static_cast<size_t>(len));
+      }
+      const uint8_t *base = source ? held.data() : data;
+
+      auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(rawSize));
+      uint8_t *out = buffer->data();
+      parallelFor(stored.size(), threads, [&](size_t b)
+                  {
+                    size_t rawLength = static_cast<size_t>(std::min(blockSize, rawSize - b * blockSize));
+                    const uint8_t *block = base + stored[b].first;
+                    if (stored[b].second == rawLength)
+                      std::memcpy(out + b * blockSize, block, rawLength);
+                    else
+                      decompressBlock(block, stored[b].second, out + b * blockSize, rawLength);
+                  });
+      return inner(out, static_cast<size_t>(rawSize), std::move(buffer));
+    }
+
+    uint64_t readVarint()
+    {
+      uint64_t v;
+      size_t n = decodeVarint(data + pos, size - pos, v);
+      // The varint may be shorter than MaxVarintSize, so a short fill is fine
+      if (n == 0 && source)
+      {
+        fill(MaxVarintSize);
+        n = decodeVarint(data + pos, size - pos, v);
+      }
+      if (n == 0)
         throw std::runtime_error("Buffer underflow");
-      std::memcpy(&value, data + pos, sizeof(T));
+      pos += n;
+      return v;
+    }
+
+    // Fixed-width scalar in the wire byte order
+    template <typename T>
+    void readFixed(T &value)
+    {
+      require(sizeof(T));
+      if (size_t width = swapWidth<T>(fmt.byteOrder))
+        swapCopyScalar(reinterpret_cast<uint8_t *>(&value), data + pos, sizeof(T) / width, width);
+      else
+        std::memcpy(&value, data + pos, sizeof(T));
       pos += sizeof(T);
     }
 
-    // String
-    void readString(std::string &s)
+    // Length prefix of strings, sequences and maps
+    uint64_t readLength()
     {
+      if (fmt.lengths == LengthEncoding::Varint)
+        return readVarint();
       uint64_t len;
-      readPod(len);
-      if (pos + len > size)
-        throw std::runtime_error("Buffer underflow");
+      readFixed(len);
+      return len;
+    }
+
+    // POD
+    template <typename T>
+    typename std::enable_if<!is_varint_integer<T>::value>::type
+    readPod(T &value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "readPod: T must be trivially copyable");
+      readFixed(value);
+    }
+
+    // Integers, see Serializer::writePod. A varint out of T's range is an error, not
+    // a truncation.
+    template <typename T>
+    typename std::enable_if<is_varint_integer<T>::value>::type
+    readPod(T &value)
+    {
+      if (fmt.integers == IntegerEncoding::Varint)
+      {
+        uint64_t v = readVarint();
+        if (std::is_signed<T>::value)
+        {
+          int64_t s = zigzagDecode(v);
+          if (s < static_cast<int64_t>(std::numeric_limits<T>::min()) || s > static_cast<int64_t>(std::numeric_limits<T>::max()))
+            throw std::runtime_error("Integer out of range");
+          value = static_cast<T>(s);
+        }
+        else
+        {
+          if (v > static_cast<uint64_t>(std::numeric_limits<T>::max()))
+            throw std::runtime_error("Integer out of range");
+          value = static_cast<T>(v);
+        }
+        return;
+      }
+      readFixed(value);
+    }
+
+    // String
+    template <typename String>
+    void readString(String &s)
+    {
+      uint64_t len = readLength();
+      if (source && len > size - pos && len > window->size() / 2)
+      {
+        readChunked(s, len);
+        return;
+      }
+      require(len);
       s.assign(reinterpret_cast<const char *>(data + pos), len);
       pos += len;
     }
 
+    // Reads the fields of a tagged struct up to its endFields() marker. handler is called
+    // as handler(Deserializer &, uint32_t tag) and reads the fields it knows. It is confined
+    // to the field's bytes, and whatever it leaves unread (an unknown field, or data a
+    // newer writer appended) is skipped in constant time.
+    template <typename Handler>
+    void readFields(Handler handler)
+    {
+      while (true)
+      {
+        uint64_t tag = readVarint();
+        if (tag == 0)
+          return;
+        if (tag > UINT32_MAX)
+          throw std::runtime_error("Malformed field tag");
+        uint64_t len = readVarint();
+        if (source)
+        {
+          // The field is decoded from its own bytes, the window or a copy of large ones
+          std::shared_ptr<const void> holder;
+          const uint8_t *p = len <= window->size() ? readRaw(len) : readShared(len, holder);
+          Deserializer field = inner(p, static_cast<size_t>(len), std::move(holder));
+          field.streamed = true;
+          handler(field, static_cast<uint32_t>(tag));
+          continue;
+        }
+        require(len);
+        size_t fieldEnd = pos + static_cast<size_t>(len);
+        size_t outer = size;
+        size = fieldEnd;
+        try
+        {
+          handler(*this, static_cast<uint32_t>(tag));
+        }
+        catch (...)
+        {
+          size = outer;
+          throw;
+        }
+        size = outer;
+        pos = fieldEnd;
+      }
+    }
+
+    // Views into the input buffer, see the lifetime rules above Span
+    template <typename T>
+    void readSpan(Span<T> &span)
+    {
+      if (!rawElements<T>())
+        throw std::runtime_error("Span requires elements stored in host layout");
+      requireInMemory();
+      uint64_t len = readLength();
+      if (len > (size - pos) / sizeof(T))
+        throw std::runtime_error("Buffer underflow");
+      span = Span<T>::fromBytes(data + pos, static_cast<size_t>(len));
+      pos += len * sizeof(T);
+    }
+
+#if __cplusplus >= 201703L
+    void readStringView(std::string_view &s)
+    {
+      requireInMemory();
+      uint64_t len = readLength();
+      require(len);
+      s = std::string_view(reinterpret_cast<const char *>(data + pos), len);
+      pos += len;
+    }
+#endif
+
     // =====================
     // readSequenceLike overloads
     // =====================
+    // Contiguous trivially copyable elements: one bounds check, one resize, one memcpy
+    template <typename Seq>
+    typename std::enable_if<is_bulk_resizable<Seq>::value>::type
+    readSequenceLike(Seq &seq)
+    {
+      using V = typename Seq::value_type;
+      uint64_t len = readLength();
+      if (is_varint_integer<V>::value && fmt.integers == IntegerEncoding::Varint)
+      {
+        // Every varint takes at least one byte
+        if (!source)
+          require(len);
+        seq.clear();
+        for (size_t done = 0; done < len;)
+        {
+          size_t step = chunkFor(done, len, 1);
+          seq.resize(done + step);
+          for (size_t k = done; k < done + step; ++k)
+            readPod(seq[k]);
+          done += step;
+        }
+        return;
+      }
+      if (source)
+      {
+        readChunked(seq, len);
+        if (size_t width = len ? swapWidth<V>(fmt.byteOrder) : 0)
+          swapCopy(&seq[0], &seq[0], len * sizeof(V) / width, width);
+        return;
+      }
+      if (len > (size - pos) / sizeof(V))
+        throw std::runtime_error("Buffer underflow");
+      const size_t width = len ? swapWidth<V>(fmt.byteOrder) : 0;
+      seq.resize(len);
+      if (width)
+        swapCopy(&seq[0], data + pos, len * sizeof(V) / width, width);
+      else if (len)
+        std::memcpy(&seq[0], data + pos, len * sizeof(V));
+      pos += len * sizeof(V);
+    }
+
     // Push-backable sequences: vector, list, deque
     template <typename Seq>
-    typename std::enable_if<has_push_back<Seq>::value>::type
+    typename std::enable_if<has_push_back<Seq>::value && !is_bulk_resizable<Seq>::value>::type
     readSequenceLike(Seq &seq)
     {
-      uint64_t len;
-      readPod(len);
-      seq.clear();
-      for (uint64_t i = 0; i < len; ++i)
+      uint64_t len = readLength();
+      if (readChunks(seq, len))
+        return;
+      if (reuse)
       {
-        typename Seq::value_type v;
-        read(v);
-        seq.push_back(std::move(v));
+        readSequenceReusing(seq, len, std::integral_constant<bool, has_emplace_back<Seq>::value &&
+                                                                   !is_constructed<typename Seq::value_type>::value>{});
+        return;
       }
+      seq.clear();
+      appendElements(seq, len);
+    }
+
+    // Existing elements are decoded over, keeping their own capacity, surplus ones are erased
+    template <typename Seq>
+    void readSequenceReusing(Seq &seq, uint64_t len, std::true_type)
+    {
+      auto it = seq.begin();
+      uint64_t i = 0;
+      for (; i < len && it != seq.end(); ++i, ++it)
+        read(*it);
+      seq.erase(it, seq.end());
+      reserveFor(seq, len - i);
+      for (; i < len; ++i)
+        readBack(seq);
+    }
+
+    template <typename Seq>
+    void readSequenceReusing(Seq &seq, uint64_t len, std::false_type)
+    {
+      seq.clear();
+      appendElements(seq, len);
+    }
+
+    // Decodes `len` elements onto the end of a container
+    template <typename Seq>
+    typename std::enable_if<has_push_back<Seq>::value>::type
+    appendElements(Seq &seq, uint64_t len)
+    {
+      reserveFor(seq, len);
+      for (uint64_t i = 0; i < len; ++i)
+        readBack(seq);
+    }
+
+    template <typename Seq>
+    typename std::enable_if<!has_push_back<Seq>::value && !is_map_like<Seq>::value>::type
+    appendElements(Seq &seq, uint64_t len)
+    {
+      reserveFor(seq, len);
+      for (uint64_t i = 0; i < len; ++i)
+        seq.insert(seq.end(), readElement<typename Seq::value_type>(seq));
+    }
+
+    template <typename Map>
+    typename std::enable_if<is_map_like<Map>::value>::type
+    appendElements(Map &map, uint64_t len)
+    {
+      reserveFor(map, len);
+      for (uint64_t i = 0; i < len; ++i)
+        emplaceMapped(map, readElement<typename Map::key_type>(map));
+    }
+
+    // Element built once: by read<V>() when V is constructed from the stream, otherwise
+    // created empty with the container's allocator and decoded
+    template <typename V, typename C>
+    typename std::enable_if<is_constructed<V>::value, V>::type
+    readElement(const C &)
+    {
+      return read<V>();
+    }
+
+    template <typename V, typename C>
+    typename std::enable_if<!is_constructed<V>::value, V>::type
+    readElement(const C &c)
+    {
+      V v = makeElement<V>(c);
+      read(v);
+      return v;
+    }
+
+    // Decoded in place, so the element is built with the container's allocator
+    template <typename Seq>
+    typename std::enable_if<has_emplace_back<Seq>::value && !is_constructed<typename Seq::value_type>::value>::type
+    readBack(Seq &seq)
+    {
+      seq.emplace_back();
+      read(seq.back());
+    }
+
+    template <typename Seq>
+    typename std::enable_if<!has_emplace_back<Seq>::value || is_constructed<typename Seq::value_type>::value>::type
+    readBack(Seq &seq)
+    {
+      seq.push_back(readElement<typename Seq::value_type>(seq));
     }
 
     // Insert-only sequences: set, unordered_set
+    // Ordered containers were written in order, so inserting at end() is amortized constant
     template <typename Seq>
     typename std::enable_if<!has_push_back<Seq>::value && has_begin_end<Seq>::value>::type
     readSequenceLike(Seq &seq)
     {
-      uint64_t len;
-      readPod(len);
-      seq.clear();
-      for (uint64_t i = 0; i < len; ++i)
+      uint64_t len = readLength();
+      if (readChunks(seq, len))
+        return;
+      if (reuse && has_node_handles<Seq>::value)
       {
-        typename Seq::value_type v;
-        read(v);
-        seq.insert(std::move(v));
+        readNodesReusing(seq, len, has_node_handles<Seq>{});
+        return;
       }
+      seq.clear();
+      appendElements(seq, len);
     }
 
     // Generic tuple-like reader
@@ -344,18 +1768,198 @@ namespace Serialization
     template <typename Map>
     void readMapLike(Map &map)
     {
-      uint64_t len;
-      readPod(len);
+      uint64_t len = readLength();
+      if (readChunks(map, len))
+        return;
+      if (reuse && has_node_handles<Map>::value)
+      {
+        readNodesReusing(map, len, has_node_handles<Map>{});
+        return;
+      }
       map.clear();
+      appendElements(map, len);
+    }
+
+    // Chunk index: [chunk size][byte size of each chunk as u64]. Decodes the chunks
+    // concurrently into separate containers and moves them into `c`, then returns true.
+    // Otherwise only the index is consumed and false returned.
+    template <typename C>
+    bool readChunks(C &c, uint64_t len)
+    {
+      if (fmt.chunkIndexThreshold == 0 || len < fmt.chunkIndexThreshold)
+        return false;
+      const uint64_t chunkSize = readLength();
+      if (chunkSize == 0)
+        throw std::runtime_error("Malformed chunk index");
+      const uint64_t chunks = (len - 1) / chunkSize + 1;
+      const bool split = parallel && !source && !reuse && chunks > 1 && has_default_allocator<C>::value;
+      if (!split)
+      {
+        uint64_t skipped;
+        for (uint64_t k = 0; k < chunks; ++k)
+          readFixed(skipped);
+        return false;
+      }
+
+      if (chunks > (size - pos) / sizeof(uint64_t))
+        throw std::runtime_error("Buffer underflow");
+      const size_t available = size - pos - static_cast<size_t>(chunks) * sizeof(uint64_t);
+      std::vector<size_t> ends(static_cast<size_t>(chunks));
+      size_t total = 0;
+      for (size_t k = 0; k < ends.size(); ++k)
+      {
+        uint64_t bytes;
+        readFixed(bytes);
+        if (bytes > available - total)
+          throw std::runtime_error("Malformed chunk index");
+        total += static_cast<size_t>(bytes);
+        ends[k] = total;
+      }
+      const uint8_t *base = readRaw(total);
+
+      std::vector<C> parts(ends.size());
+      parallelFor(parts.size(), parallelOptions.threads, [&](size_t k)
+                  {
+                    size_t begin = k ? ends[k - 1] : 0;
+                    Deserializer d = inner(base + begin, ends[k] - begin, keepAlive);
+                    d.parallel = false;
+                    d.appendElements(parts[k], std::min<uint64_t>(chunkSize, len - k * chunkSize));
+                    if (d.pos != d.size)
+                      throw std::runtime_error("Malformed chunk index");
+                  });
+      mergeChunks(c, parts, len);
+      return true;
+    }
+
+    // Chunks of a sequence are appended in order
+    template <typename Seq>
+    typename std::enable_if<has_push_back<Seq>::value>::type
+    mergeChunks(Seq &seq, std::vector<Seq> &parts, uint64_t len)
+    {
+      seq = std::move(parts[0]);
+      reserveTotal(seq, len);
+      for (size_t k = 1; k < parts.size(); ++k)
+        seq.insert(seq.end(), std::make_move_iterator(parts[k].begin()), std::make_move_iterator(parts[k].end()));
+    }
+
+    // Nodes of sets and maps are relinked, not copied. Like a sequential read, the
+    // first of duplicate keys is kept.
+    template <typename C>
+    typename std::enable_if<!has_push_back<C>::value>::type
+    mergeChunks(C &c, std::vector<C> &parts, uint64_t len)
+    {
+      c = std::move(parts[0]);
+      reserveTotal(c, len);
+      for (size_t k = 1; k < parts.size(); ++k)
+        mergeNodes(c, parts[k], has_node_handles<C>{});
+    }
+
+#if __cplusplus >= 201703L
+    template <typename C>
+    static void mergeNodes(C &c, C &part, std::true_type)
+    {
+      c.merge(part);
+    }
+#endif
+
+    template <typename C>
+    static void mergeNodes(C &c, C &part, std::false_type)
+    {
+      c.insert(std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+    }
+
+#if __cplusplus >= 201703L
+    // Nodes taken out of containers being re-read, one pool per container type and
+    // thread. Used as a stack, so nested reads of the same type keep their own nodes.
+    template <typename C>
+    static std::vector<typename C::node_type> &nodePool()
+    {
+      static thread_local std::vector<typename C::node_type> pool;
+      return pool;
+    }
+
+    // Frees the nodes a read did not reuse, also when it throws
+    template <typename C>
+    struct NodePoolGuard
+    {
+      std::vector<typename C::node_type> &pool;
+      size_t base;
+      ~NodePoolGuard() { pool.erase(pool.begin() + base, pool.end()); }
+    };
+
+    template <typename C>
+    static void readNode(Deserializer &d, typename C::node_type &node, std::true_type)
+    {
+      d.read(node.key());
+      d.read(node.mapped());
+    }
+
+    template <typename C>
+    static void readNode(Deserializer &d, typename C::node_type &node, std::false_type)
+    {
+      d.read(node.value());
+    }
+
+    // Decodes into the container's existing nodes (keys, values and their capacity are
+    // reused) and re-links them, only missing elements are allocated
+    template <typename C>
+    void readNodesReusing(C &c, uint64_t len, std::true_type)
+    {
+      auto &pool = nodePool<C>();
+      NodePoolGuard<C> guard{pool, pool.size()};
+      while (!c.empty())
+        pool.push_back(c.extract(c.begin()));
+      reserveFor(c, len);
       for (uint64_t i = 0; i < len; ++i)
       {
-        typename Map::key_type k;
-        typename Map::mapped_type v;
-        read(k);
-        read(v);
-        map.emplace(std::move(k), std::move(v));
+        if (pool.size() == guard.base)
+        {
+          insertElement(c);
+          continue;
+        }
+        typename C::node_type node = std::move(pool.back());
+        pool.pop_back();
+        readNode<C>(*this, node, is_map_like<C>{});
+        c.insert(c.end(), std::move(node));
       }
     }
+#endif
+
+    template <typename C>
+    void readNodesReusing(C &, uint64_t, std::false_type) {}
+
+    template <typename C>
+    typename std::enable_if<is_map_like<C>::value>::type insertElement(C &map)
+    {
+      emplaceMapped(map, readElement<typename C::key_type>(map));
+    }
+
+    template <typename C>
+    typename std::enable_if<!is_map_like<C>::value>::type insertElement(C &seq)
+    {
+      seq.insert(seq.end(), readElement<typename C::value_type>(seq));
+    }
+
+    // The mapped value is decoded in its node when it can be created empty. Of
+    // duplicate keys the first is kept, later values are decoded and dropped.
+    template <typename Map>
+    typename std::enable_if<!is_constructed<typename Map::mapped_type>::value>::type
+    emplaceMapped(Map &map, typename Map::key_type &&k)
+    {
+      const size_t before = map.size();
+      auto it = map.emplace_hint(map.end(), std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple());
+      if (map.size() != before)
+        read(it->second);
+      else
+        readElement<typename Map::mapped_type>(map);
+    }
+
+    template <typename Map>
+    typename std::enable_if<is_constructed<typename Map::mapped_type>::value>::type
+    emplaceMapped(Map &map, typename Map::key_type &&k)
+    {
+      map.emplace_hint(map.end(), std::move(k), read<typename Map::mapped_type>());
+    }
 
     // Custom structure deserialization
     template <typename T>
@@ -370,6 +1974,169 @@ namespace Serialization
     const uint8_t *data;
     size_t pos = 0;
     size_t size = 0;
+    std::shared_ptr<const void> keepAlive;
+    bool zeroCopy = false;
+    WireFormat fmt;
+    size_t checksumStart = 0;
+    bool reuse = false;
+    bool parallel = false;
+    ParallelOptions parallelOptions;
+    // Streaming input: [data, data + size) is the buffered part of the window
+    Source *source = nullptr;
+    std::shared_ptr<std::vector<uint8_t>> window;
+    // Size the window returns to after a readRaw() grew it
+    size_t windowSize = 0;
+    uint64_t maxAllocation = uint64_t(1) << 30;
+    // Reads from a stream window, which moves on, so views into it are not allowed
+    bool streamed = false;
+    // CRC of bytes that left the window since beginChecksum()
+    uint32_t checksum = 0;
+    bool checksumming = false;
+#if defined(SERIALIZATION_HAS_PMR)
+    std::pmr::memory_resource *memory = nullptr;
+#endif
+
+    template <typename T>
+    friend class Lazy;
+
+    // Deserializer over nested bytes that inherits this one's settings
+    Deserializer inner(const uint8_t *p, size_t length, std::shared_ptr<const void> owner) const
+    {
+      Deserializer d(p, length, std::move(owner));
+      d.fmt = fmt;
+      d.zeroCopy = zeroCopy;
+      d.reuse = reuse;
+      d.parallel = parallel;
+      d.parallelOptions = parallelOptions;
+      d.maxAllocation = maxAllocation;
+#if defined(SERIALIZATION_HAS_PMR)
+      d.memory = memory;
+#endif
+      return d;
+    }
+
+    // Elements of type T are stored as their host bytes in the current format
+    template <typename T>
+    bool rawElements() const
+    {
+      return !(is_varint_integer<T>::value && fmt.integers == IntegerEncoding::Varint) &&
+             swapWidth<T>(fmt.byteOrder) == 0;
+    }
+
+    // Throws unless `n` more bytes are available
+    void require(uint64_t n)
+    {
+      if (n > size - pos && !fill(n))
+        throw std::runtime_error("Buffer underflow");
+    }
+
+    // Throws when a stream would allocate `n` bytes before receiving them
+    void checkAllocation(uint64_t n) const
+    {
+      if (source && n > maxAllocation)
+        throw std::runtime_error("Allocation limit exceeded");
+    }
+
+    void requireInMemory() const
+    {
+      if (streamed)
+        throw std::runtime_error("Views require an in-memory input");
+    }
+
+    void foldChecksum()
+    {
+      if (checksumming)
+      {
+        checksum = crc32c(data + checksumStart, pos - checksumStart, checksum);
+        checksumStart = pos;
+      }
+    }
+
+    // Moves the unread bytes to the front of the window and refills it until `n` are
+    // buffered. Returns false when the input ends first. A window grown for a large `n`
+    // shrinks back on the next refill that fits.
+    bool fill(uint64_t n)
+    {
+      if (!source)
+        return false;
+      foldChecksum();
+      std::vector<uint8_t> &w = *window;
+      size_t unread = size - pos;
+      if (n > w.size() || (w.size() > windowSize && n <= windowSize))
+      {
+        checkAllocation(n);
+        std::vector<uint8_t> resized(std::max(static_cast<size_t>(n), windowSize));
+        std::memcpy(resized.data(), data + pos, unread);
+        w.swap(resized);
+      }
+      else
+        std::memmove(w.data(), data + pos, unread);
+      data = w.data();
+      pos = 0;
+      size = unread;
+      checksumStart = 0;
+      while (size < n)
+      {
+        size_t got = source->read(w.data() + size, w.size() - size);
+        if (got == 0)
+          return false;
+        size += got;
+      }
+      return true;
+    }
+
+    // Elements to add in the next step of reading `len` of them. A stream grows the
+    // container with the input actually received, so a corrupt length cannot allocate
+    // far beyond it.
+    size_t chunkFor(size_t done, uint64_t len, size_t elementSize) const
+    {
+      if (!source)
+        return static_cast<size_t>(len - done);
+      size_t step = std::max(done, window->size() / elementSize + 1);
+      return static_cast<size_t>(std::min<uint64_t>(len - done, step));
+    }
+
+    // Reads `len` raw elements into a contiguous container (string, POD vector)
+    template <typename C>
+    void readChunked(C &c, uint64_t len)
+    {
+      using V = typename C::value_type;
+      if (!source && len > (size - pos) / sizeof(V))
+        throw std::runtime_error("Buffer underflow");
+      c.clear();
+      for (size_t done = 0; done < len;)
+      {
+        size_t step = chunkFor(done, len, sizeof(V));
+        c.resize(done + step);
+        readBytes(&c[done], step * sizeof(V));
+        done += step;
+      }
+    }
+
+    // Reserve room for `len` decoded elements. Every element takes at least one
+    // byte, so a corrupt length cannot reserve more than the remaining input.
+    template <typename C>
+    typename std::enable_if<has_reserve<C>::value>::type
+    reserveFor(C &c, uint64_t len)
+    {
+      c.reserve(static_cast<size_t>(std::min<uint64_t>(len, size - pos)));
+    }
+
+    template <typename C>
+    typename std::enable_if<!has_reserve<C>::value>::type
+    reserveFor(C &, uint64_t) {}
+
+    // For `len` elements that are already decoded
+    template <typename C>
+    typename std::enable_if<has_reserve<C>::value>::type
+    reserveTotal(C &c, uint64_t len)
+    {
+      c.reserve(static_cast<size_t>(len));
+    }
+
+    template <typename C>
+    typename std::enable_if<!has_reserve<C>::value>::type
+    reserveTotal(C &, uint64_t) {}
 
     // =====================
     // Read dispatcher (SFINAE)
@@ -384,7 +2151,9 @@ namespace Serialization
     };
 
     template <typename T>
-    struct read_helper<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+    struct read_helper<T, typename std::enable_if<std::is_trivially_copyable<T>::value && !is_view<T>::value &&
+                                                  !has_deserialize<T>::value && !has_construct<T>::value &&
+                                                  (!is_tuple_like<T>::value || is_bulk_copyable<T>::value)>::type>
     {
       static void apply(Deserializer &d, T &v) { d.readPod(v); }
     };
@@ -402,7 +2171,8 @@ namespace Serialization
     };
 
     template <typename T>
-    struct read_helper<T, typename std::enable_if<is_tuple_like<T>::value>::type>
+    struct read_helper<T, typename std::enable_if<is_tuple_like<T>::value && !is_bulk_copyable<T>::value &&
+                                                  !has_deserialize<T>::value && !has_construct<T>::value>::type>
     {
       static void apply(Deserializer &d, T &v) { d.readTupleLike(v); }
     };
@@ -410,23 +2180,97 @@ namespace Serialization
     template <typename T>
     struct read_helper<T, typename std::enable_if<!is_map_like<T>::value &&
                                                   !is_std_string<T>::value &&
+                                                  !is_tuple_like<T>::value &&
+                                                  !is_view<T>::value &&
                                                   has_begin_end<T>::value>::type>
     {
       static void apply(Deserializer &d, T &v) { d.readSequenceLike(v); }
     };
 
+    template <typename T>
+    struct read_helper<Span<T>>
+    {
+      static void apply(Deserializer &d, Span<T> &v) { d.readSpan(v); }
+    };
+
+#if __cplusplus >= 201703L
+    template <typename T>
+    struct read_helper<T, typename std::enable_if<std::is_same<T, std::string_view>::value>::type>
+    {
+      static void apply(Deserializer &d, T &v) { d.readStringView(v); }
+    };
+#endif
+
     template <typename T>
     struct read_helper<T, typename std::enable_if<has_deserialize<T>::value>::type>
     {
       static void apply(Deserializer &d, T &v) { d.readCustom(v); }
     };
 
+    template <typename T>
+    struct read_helper<T, typename std::enable_if<has_construct<T>::value && !has_deserialize<T>::value>::type>
+    {
+      static void apply(Deserializer &d, T &v) { v = T::construct(&d); }
+    };
+
+    // read<T>() dispatch
+    template <typename T, typename = void>
+    struct constructor
+    {
+      static T apply(Deserializer &d)
+      {
+        T v = d.emptyValue<T>();
+        d.read(v);
+        return v;
+      }
+    };
+
+    template <typename T>
+    struct constructor<T, typename std::enable_if<has_construct<T>::value>::type>
+    {
+      static T apply(Deserializer &d) { return T::construct(&d); }
+    };
+
+    // Braced initializers evaluate left to right, so elements are read in order
+    template <typename A, typename B>
+    struct constructor<std::pair<A, B>, typename std::enable_if<!std::is_default_constructible<std::pair<A, B>>::value>::type>
+    {
+      static std::pair<A, B> apply(Deserializer &d) { return std::pair<A, B>{d.read<A>(), d.read<B>()}; }
+    };
+
+    template <typename... Ts>
+    struct constructor<std::tuple<Ts...>, typename std::enable_if<!std::is_default_constructible<std::tuple<Ts...>>::value>::type>
+    {
+      static std::tuple<Ts...> apply(Deserializer &d) { return std::tuple<Ts...>{d.read<Ts>()...}; }
+    };
+
+    template <typename T>
+    T emptyValue() const
+    {
+#if defined(SERIALIZATION_HAS_PMR)
+      return make<T>();
+#else
+      return T();
+#endif
+    }
+
   public:
     template <typename T>
     void read(T &value)
     {
       read_helper<T>::apply(*this, value);
     }
+
+    // Value-returning read, the result is built once. Types with a
+    // `static T construct(Deserializer *)` are created by it, which also allows types
+    // without a default constructor; pairs and tuples of those are built element by
+    // element. Anything else is created empty (bound to memoryResource() when it is
+    // allocator-aware) and read.
+    template <typename T>
+    T read()
+    {
+      return constructor<T>::apply(*this);
+    }
   };
 
 } // namespace Serialization
@@ -434,3 +2278,8 @@ namespace Serialization
 #endif // _SERIALIZATION_HPP_
 
 #include "Serialization.tpp"
+#include "Indexed.hpp"
+#include "Lazy.hpp"
+#include "Compressed.hpp"
+#include "FrameDecoder.hpp"
+#include "MappedArchive.hpp"
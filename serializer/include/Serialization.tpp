@@ -7,6 +7,21 @@
 
 namespace Serialization
 {
+    // cv::Mat read in zero-copy mode together with the Deserializer's owner(), which
+    // keeps the input buffer alive for as long as the view is held. When the pixels
+    // cannot be wrapped the Mat is an owning copy and owner is empty.
+    struct MatView
+    {
+        cv::Mat mat;
+        std::shared_ptr<const void> owner;
+    };
+
+    // Pixels can be wrapped when they are aligned for the element depth
+    inline bool isMatAligned(const uint8_t *p, int type)
+    {
+        return reinterpret_cast<uintptr_t>(p) % CV_ELEM_SIZE1(type) == 0;
+    }
+
     template <>
     inline void Serializer::write<cv::Point>(const cv::Point &p)
     {
@@ -32,22 +47,35 @@ namespace Serialization
     template <>
     inline void Serializer::write<cv::Mat>(const cv::Mat &m)
     {
+        presize(m);
+        DepthGuard guard(depth);
         int rows = m.rows, cols = m.cols, type = m.type();
         write(rows);
         write(cols);
         write(type);
         size_t dataSize = m.total() * m.elemSize();
         write(dataSize);
+        // Elements wider than a byte are reordered for a non-native byte order
+        size_t width = m.elemSize1();
+        bool swap = width > 1 && needsByteSwap(fmt.byteOrder);
         if (m.isContinuous())
         {
-            const uint8_t *d = m.data;
-            buffer.insert(buffer.end(), d, d + dataSize);
+            if (swap)
+                writeSwapped(m.data, dataSize / width, width);
+            else
+                writeBlob(m.data, dataSize);
         }
         else
         {
-            cv::Mat tmp = m.clone();
-            const uint8_t *d = tmp.data;
-            buffer.insert(buffer.end(), d, d + dataSize);
+            // Copy row by row instead of cloning the whole matrix first
+            size_t rowSize = m.cols * m.elemSize();
+            for (int r = 0; r < m.rows; ++r)
+            {
+                if (swap)
+                    writeSwapped(m.ptr(r), rowSize / width, width);
+                else
+                    writeBlob(m.ptr(r), rowSize);
+            }
         }
     }
 
@@ -80,11 +108,61 @@ namespace Serialization
         read(cols);
         read(type);
         read(dataSize);
-        m.create(rows, cols, type);
-        if (pos + dataSize > size)
-            throw std::runtime_error("Buffer underflow");
-        std::memcpy(m.data, data + pos, dataSize);
+        size_t elemSize = CV_ELEM_SIZE(type);
+        if (rows < 0 || cols < 0 || (cols && static_cast<size_t>(rows) > SIZE_MAX / cols / elemSize) ||
+            dataSize != static_cast<size_t>(rows) * cols * elemSize)
+            throw std::runtime_error("Matrix size mismatch");
+        size_t width = CV_ELEM_SIZE1(type);
+        bool swap = width > 1 && needsByteSwap(fmt.byteOrder);
+        if (source)
+        {
+            // The pixels are allocated before they arrive, so the header is bounded first
+            checkAllocation(dataSize);
+            m.create(rows, cols, type);
+            readBytes(m.data, dataSize);
+            if (swap)
+                swapCopy(m.data, m.data, dataSize / width, width);
+            return;
+        }
+        require(dataSize);
+        const uint8_t *pixels = data + pos;
         pos += dataSize;
+        if (zeroCopy && !streamed && !swap && isMatAligned(pixels, type))
+        {
+            m = cv::Mat(rows, cols, type, const_cast<uint8_t *>(pixels));
+            return;
+        }
+        m.create(rows, cols, type);
+        if (swap)
+            swapCopy(m.data, pixels, dataSize / width, width);
+        else
+            std::memcpy(m.data, pixels, dataSize);
+    }
+
+    template <>
+    inline void Serializer::write<MatView>(const MatView &v)
+    {
+        write(v.mat);
+    }
+
+    template <>
+    inline void Deserializer::read<MatView>(MatView &v)
+    {
+        bool previous = zeroCopy;
+        zeroCopy = true;
+        const uint8_t *begin = data + pos;
+        try
+        {
+            read(v.mat);
+        }
+        catch (...)
+        {
+            zeroCopy = previous;
+            throw;
+        }
+        zeroCopy = previous;
+        bool wrapped = v.mat.data >= begin && v.mat.data < data + pos;
+        v.owner = wrapped ? keepAlive : nullptr;
     }
 } // namespace Serialization
 
@@ -0,0 +1,489 @@
+#ifndef _SINKS_HPP_
+#define _SINKS_HPP_
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <ostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+namespace Serialization
+{
+  class Serializer;
+
+  // =====================
+  // Output sinks
+  // =====================
+  // A sink exposes a writable window [cur, end) that the Serializer fills directly.
+  // overflow() is only called when a write does not fit in the remaining window.
+  class Sink
+  {
+  public:
+    virtual ~Sink() = default;
+
+    // Consume `n` bytes at `p` that did not fit in the current window
+    virtual void overflow(const uint8_t *p, size_t n) = 0;
+
+    // Push buffered bytes to the destination
+    virtual void flush() {}
+
+    // Hint that `n` more bytes are about to be written, only called when sizeHints is set
+    virtual void reserve(size_t) {}
+
+    // Take `n` bytes at `p` by reference instead of copying them, only offered for
+    // payloads of at least referenceThreshold bytes. Return false to have them copied.
+    virtual bool reference(const uint8_t *, size_t) { return false; }
+
+  protected:
+    uint8_t *cur = nullptr;
+    uint8_t *end = nullptr;
+    // Ask the Serializer to run the size pre-pass and call reserve() before top-level writes
+    bool sizeHints = false;
+    size_t referenceThreshold = SIZE_MAX;
+
+    friend class Serializer;
+  };
+
+  // Growable std::vector, the default Serializer storage
+  class VectorSink : public Sink
+  {
+  public:
+    VectorSink() { sizeHints = true; }
+
+    // Adopt caller-owned storage: its capacity is reused, its contents are discarded
+    explicit VectorSink(std::vector<uint8_t> &&storage) : buffer(std::move(storage))
+    {
+      sizeHints = true;
+      buffer.resize(buffer.capacity());
+      rewind(0);
+    }
+
+    VectorSink(const VectorSink &other) : buffer(other.data(), other.data() + other.size())
+    {
+      sizeHints = true;
+      rewind(buffer.size());
+    }
+
+    VectorSink(VectorSink &&other) noexcept : buffer(std::move(other.buffer))
+    {
+      sizeHints = true;
+      cur = other.cur;
+      end = other.end;
+      other.cur = other.end = nullptr;
+    }
+
+    VectorSink &operator=(const VectorSink &other)
+    {
+      if (this != &other)
+      {
+        buffer.assign(other.data(), other.data() + other.size());
+        rewind(buffer.size());
+      }
+      return *this;
+    }
+
+    VectorSink &operator=(VectorSink &&other) noexcept
+    {
+      if (this != &other)
+      {
+        buffer = std::move(other.buffer);
+        cur = other.cur;
+        end = other.end;
+        other.cur = other.end = nullptr;
+      }
+      return *this;
+    }
+
+    void overflow(const uint8_t *p, size_t n) override
+    {
+      grow(n);
+      std::memcpy(cur, p, n);
+      cur += n;
+    }
+
+    void reserve(size_t n) override
+    {
+      if (static_cast<size_t>(end - cur) < n)
+        grow(n);
+    }
+
+    const uint8_t *data() const { return buffer.data(); }
+    size_t size() const { return cur ? static_cast<size_t>(cur - buffer.data()) : 0; }
+    size_t capacity() const { return buffer.capacity(); }
+
+    // Discard the written bytes but keep the allocation
+    void clear() { rewind(0); }
+
+    // Hand over the written bytes, the sink is left empty
+    std::vector<uint8_t> release()
+    {
+      buffer.resize(size());
+      std::vector<uint8_t> out;
+      out.swap(buffer);
+      cur = end = nullptr;
+      return out;
+    }
+
+  private:
+    // The vector is kept resized to its whole capacity, size() tracks the written part
+    std::vector<uint8_t> buffer;
+
+    void rewind(size_t used)
+    {
+      cur = buffer.data() + used;
+      end = buffer.data() + buffer.size();
+    }
+
+    void grow(size_t n)
+    {
+      size_t used = size();
+      buffer.resize(std::max(used + n, 2 * buffer.size()));
+      rewind(used);
+    }
+  };
+
+  // Fixed caller-provided memory, writing past its end throws
+  class SpanSink : public Sink
+  {
+  public:
+    SpanSink(uint8_t *data, size_t length) : begin(data)
+    {
+      cur = data;
+      end = data + length;
+    }
+
+    void overflow(const uint8_t *, size_t) override
+    {
+      throw std::runtime_error("Buffer overflow");
+    }
+
+    const uint8_t *data() const { return begin; }
+    size_t size() const { return static_cast<size_t>(cur - begin); }
+    size_t remaining() const { return static_cast<size_t>(end - cur); }
+    void clear() { cur = begin; }
+
+  private:
+    uint8_t *begin;
+  };
+
+  // Scatter-gather output: small writes are copied into an inline buffer, large
+  // contiguous payloads (strings, POD arrays, cv::Mat pixels) are only referenced.
+  // Referenced memory must stay valid and unchanged until the output is consumed
+  // with segments(), copyTo() or writeTo().
+  class GatherSink : public Sink
+  {
+  public:
+    struct Segment
+    {
+      const uint8_t *data;
+      size_t size;
+    };
+
+    explicit GatherSink(size_t threshold = 4096)
+    {
+      referenceThreshold = std::max<size_t>(threshold, 1);
+    }
+
+    GatherSink(const GatherSink &) = delete;
+    GatherSink &operator=(const GatherSink &) = delete;
+
+    void overflow(const uint8_t *p, size_t n) override
+    {
+      size_t used = inlineSize();
+      inlineBytes.resize(std::max(used + n, 2 * inlineBytes.size()));
+      cur = inlineBytes.data() + used;
+      end = inlineBytes.data() + inlineBytes.size();
+      std::memcpy(cur, p, n);
+      cur += n;
+    }
+
+    bool reference(const uint8_t *p, size_t n) override
+    {
+      closeInline();
+      pieces.push_back(Piece{p, 0, n});
+      referenced += n;
+      return true;
+    }
+
+    // Total output size
+    size_t size() const { return inlineSize() + referenced; }
+
+    // Output in order, inline pieces point into the sink and move on the next write
+    std::vector<Segment> segments() const
+    {
+      std::vector<Segment> out;
+      out.reserve(pieces.size() + 1);
+      for (const Piece &piece : pieces)
+        out.push_back(resolve(piece));
+      size_t used = inlineSize();
+      if (used > inlineStart)
+        out.push_back(Segment{inlineBytes.data() + inlineStart, used - inlineStart});
+      return out;
+    }
+
+    // The single final copy
+    void copyTo(uint8_t *dst) const
+    {
+      for (const Segment &segment : segments())
+      {
+        std::memcpy(dst, segment.data, segment.size);
+        dst += segment.size;
+      }
+    }
+
+#ifndef _WIN32
+    // Writes the output to a POSIX file descriptor with writev()
+    void writeTo(int fd) const
+    {
+      std::vector<Segment> pending = segments();
+      std::vector<iovec> iov;
+      size_t first = 0;
+      while (first < pending.size())
+      {
+        iov.clear();
+        for (size_t k = first; k < pending.size() && iov.size() < IOV_MAX; ++k)
+          iov.push_back(iovec{const_cast<uint8_t *>(pending[k].data), pending[k].size});
+        ssize_t written = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+        if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw std::runtime_error("Write to file descriptor failed");
+        }
+        // Skip what was written, a partial write resumes inside a segment
+        size_t done = static_cast<size_t>(written);
+        while (first < pending.size() && done >= pending[first].size)
+          done -= pending[first++].size;
+        if (done)
+        {
+          pending[first].data += done;
+          pending[first].size -= done;
+        }
+      }
+    }
+#endif
+
+    // Drop the output, the inline buffer keeps its capacity
+    void clear()
+    {
+      cur = inlineBytes.data();
+      pieces.clear();
+      inlineStart = 0;
+      referenced = 0;
+    }
+
+  private:
+    // Referenced memory, or inline bytes at `offset` when external is null. Offsets
+    // stay valid when the inline buffer grows.
+    struct Piece
+    {
+      const uint8_t *external;
+      size_t offset;
+      size_t size;
+    };
+
+    std::vector<uint8_t> inlineBytes;
+    std::vector<Piece> pieces;
+    size_t inlineStart = 0;
+    size_t referenced = 0;
+
+    size_t inlineSize() const { return cur ? static_cast<size_t>(cur - inlineBytes.data()) : 0; }
+
+    void closeInline()
+    {
+      size_t used = inlineSize();
+      if (used > inlineStart)
+        pieces.push_back(Piece{nullptr, inlineStart, used - inlineStart});
+      inlineStart = used;
+    }
+
+    Segment resolve(const Piece &piece) const
+    {
+      return Segment{piece.external ? piece.external : inlineBytes.data() + piece.offset, piece.size};
+    }
+  };
+
+  // Stages small writes in a fixed buffer and hands them to put() in large blocks.
+  // Payloads at least as large as the staging buffer bypass it, so memory use does
+  // not depend on the size of what is written.
+  class BufferedSink : public Sink
+  {
+  public:
+    explicit BufferedSink(size_t stagingSize = 64 * 1024) : staging(std::max<size_t>(stagingSize, 1))
+    {
+      cur = staging.data();
+      end = staging.data() + staging.size();
+      referenceThreshold = staging.size();
+    }
+
+    BufferedSink(const BufferedSink &) = delete;
+    BufferedSink &operator=(const BufferedSink &) = delete;
+
+    void overflow(const uint8_t *p, size_t n) override
+    {
+      drain();
+      if (n >= staging.size())
+      {
+        put(p, n);
+        return;
+      }
+      std::memcpy(cur, p, n);
+      cur += n;
+    }
+
+    // Strings, POD arrays and Mat data go straight from their own memory
+    bool reference(const uint8_t *p, size_t n) override
+    {
+      drain();
+      put(p, n);
+      return true;
+    }
+
+    void flush() override
+    {
+      drain();
+    }
+
+  protected:
+    virtual void put(const uint8_t *p, size_t n) = 0;
+
+  private:
+    std::vector<uint8_t> staging;
+
+    // Hands the staged bytes to put(). Refills use this rather than flush(), so a
+    // derived flush() that also syncs its target runs only when asked for.
+    void drain()
+    {
+      size_t n = static_cast<size_t>(cur - staging.data());
+      cur = staging.data();
+      if (n)
+        put(staging.data(), n);
+    }
+  };
+
+  // Generic "write bytes" callback
+  class CallbackSink : public BufferedSink
+  {
+  public:
+    using Callback = std::function<void(const uint8_t *, size_t)>;
+
+    explicit CallbackSink(Callback cb, size_t stagingSize = 64 * 1024)
+        : BufferedSink(stagingSize), callback(std::move(cb)) {}
+
+    ~CallbackSink() override
+    {
+      try
+      {
+        flush();
+      }
+      catch (...)
+      {
+      }
+    }
+
+  protected:
+    void put(const uint8_t *p, size_t n) override { callback(p, n); }
+
+  private:
+    Callback callback;
+  };
+
+  // Buffered std::ostream, flush() also flushes the stream
+  class OStreamSink : public BufferedSink
+  {
+  public:
+    explicit OStreamSink(std::ostream &os, size_t stagingSize = 64 * 1024) : BufferedSink(stagingSize), os(os) {}
+
+    ~OStreamSink() override
+    {
+      try
+      {
+        flush();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    void flush() override
+    {
+      BufferedSink::flush();
+      os.flush();
+      if (!os)
+        throw std::runtime_error("Write to stream failed");
+    }
+
+  protected:
+    void put(const uint8_t *p, size_t n) override
+    {
+      if (!os.write(reinterpret_cast<const char *>(p), static_cast<std::streamsize>(n)))
+        throw std::runtime_error("Write to stream failed");
+    }
+
+  private:
+    std::ostream &os;
+  };
+
+#ifndef _WIN32
+  // Buffered POSIX file descriptor, the descriptor is not closed
+  class FdSink : public BufferedSink
+  {
+  public:
+    explicit FdSink(int fd, size_t stagingSize = 64 * 1024) : BufferedSink(stagingSize), fd(fd) {}
+
+    // Flushes and forgets the descriptor, for an owner about to close it. Later
+    // writes throw instead of reaching whatever file reuses the number.
+    void detach()
+    {
+      flush();
+      fd = -1;
+    }
+
+    ~FdSink() override
+    {
+      try
+      {
+        flush();
+      }
+      catch (...)
+      {
+      }
+    }
+
+  protected:
+    void put(const uint8_t *p, size_t n) override
+    {
+      if (fd < 0)
+        throw std::runtime_error("Write to a detached file descriptor");
+      while (n > 0)
+      {
+        ssize_t written = ::write(fd, p, n);
+        if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw std::runtime_error("Write to file descriptor failed");
+        }
+        p += written;
+        n -= static_cast<size_t>(written);
+      }
+    }
+
+  private:
+    int fd;
+  };
+#endif
+
+} // namespace Serialization
+
+#endif // _SINKS_HPP_
@@ -0,0 +1,74 @@
+#ifndef _SOURCES_HPP_
+#define _SOURCES_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <istream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Serialization
+{
+  // =====================
+  // Input sources
+  // =====================
+  // A source feeds a streaming Deserializer, which keeps a bounded window of the
+  // input and refills it as reads need more bytes. Large strings, POD arrays and
+  // cv::Mat pixels are read straight into their destination.
+  class Source
+  {
+  public:
+    virtual ~Source() = default;
+
+    // Reads up to `n` bytes into `p` and returns the count, 0 only at the end of the input
+    virtual size_t read(uint8_t *p, size_t n) = 0;
+  };
+
+  class IStreamSource : public Source
+  {
+  public:
+    explicit IStreamSource(std::istream &is) : is(is) {}
+
+    size_t read(uint8_t *p, size_t n) override
+    {
+      is.read(reinterpret_cast<char *>(p), static_cast<std::streamsize>(n));
+      if (is.bad())
+        throw std::runtime_error("Read from stream failed");
+      return static_cast<size_t>(is.gcount());
+    }
+
+  private:
+    std::istream &is;
+  };
+
+#ifndef _WIN32
+  // POSIX file descriptor, the descriptor is not closed
+  class FdSource : public Source
+  {
+  public:
+    explicit FdSource(int fd) : fd(fd) {}
+
+    size_t read(uint8_t *p, size_t n) override
+    {
+      while (true)
+      {
+        ssize_t got = ::read(fd, p, n);
+        if (got >= 0)
+          return static_cast<size_t>(got);
+        if (errno != EINTR)
+          throw std::runtime_error("Read from file descriptor failed");
+      }
+    }
+
+  private:
+    int fd;
+  };
+#endif
+
+} // namespace Serialization
+
+#endif // _SOURCES_HPP_
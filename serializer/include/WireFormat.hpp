@@ -0,0 +1,192 @@
+#ifndef _WIRE_FORMAT_HPP_
+#define _WIRE_FORMAT_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <array>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Serialization
+{
+  // =====================
+  // Wire format
+  // =====================
+  // The writer and the reader of a message must use the same WireFormat.
+
+  // Encoding of string, sequence and map length prefixes
+  enum class LengthEncoding : uint8_t
+  {
+    Fixed64, // 8 byte uint64_t
+    Varint   // LEB128
+  };
+
+  // Encoding of integers wider than one byte
+  enum class IntegerEncoding : uint8_t
+  {
+    Fixed,  // sizeof(T) bytes
+    Varint  // LEB128, zigzag for signed types
+  };
+
+  // Byte order of fixed-width scalars (integers, floating point, enums, Fixed64 lengths)
+  // and of 16/32/64 bit array and cv::Mat elements. Varints are byte order independent.
+  enum class ByteOrder : uint8_t
+  {
+    Native, // host order, not portable between hosts
+    Little,
+    Big
+  };
+
+  struct WireFormat
+  {
+    LengthEncoding lengths = LengthEncoding::Fixed64;
+    IntegerEncoding integers = IntegerEncoding::Fixed;
+    ByteOrder byteOrder = ByteOrder::Native;
+    // Sequences and maps with at least this many elements, other than bulk POD
+    // arrays, are split into chunks of chunkElements elements and preceded by a table
+    // of the chunk byte sizes, so a reader can decode the chunks in parallel. 0 writes
+    // no tables.
+    uint32_t chunkIndexThreshold = 0;
+    uint32_t chunkElements = 1024;
+
+    // Varint lengths and integers, best for small records
+    static WireFormat compact()
+    {
+      WireFormat f;
+      f.lengths = LengthEncoding::Varint;
+      f.integers = IntegerEncoding::Varint;
+      return f;
+    }
+
+    bool operator==(const WireFormat &other) const
+    {
+      return lengths == other.lengths && integers == other.integers && byteOrder == other.byteOrder &&
+             chunkIndexThreshold == other.chunkIndexThreshold && chunkElements == other.chunkElements;
+    }
+
+    bool operator!=(const WireFormat &other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  // Scalars whose bytes are reordered for a non-native ByteOrder
+  template <typename T>
+  struct is_byte_order_scalar : std::integral_constant<bool, (std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+                                                                 (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+  // Width of the scalars a trivially copyable value is reordered by for a non-native
+  // ByteOrder: the scalar itself, the element scalars of a std::array, 1 for single
+  // bytes, which are never reordered, and 0 for other aggregates, whose layout is unknown
+  template <typename T>
+  struct swap_width : std::integral_constant<size_t, is_byte_order_scalar<T>::value || sizeof(T) == 1 ? sizeof(T) : 0> {};
+
+  template <typename T, size_t N>
+  struct swap_width<std::array<T, N>> : swap_width<T> {};
+
+  // Integers that IntegerEncoding::Varint applies to
+  template <typename T>
+  struct is_varint_integer : std::integral_constant<bool, std::is_integral<T>::value &&
+                                                              !std::is_same<T, bool>::value &&
+                                                              (sizeof(T) > 1)> {};
+
+  // =====================
+  // Varint helpers
+  // =====================
+  const size_t MaxVarintSize = 10;
+
+  inline uint64_t zigzagEncode(int64_t v)
+  {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+  }
+
+  inline int64_t zigzagDecode(uint64_t v)
+  {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+
+  inline size_t varintSize(uint64_t v)
+  {
+    size_t n = 1;
+    while (v >= 0x80)
+    {
+      v >>= 7;
+      ++n;
+    }
+    return n;
+  }
+
+  // Writes `v` to `out`, which must hold MaxVarintSize bytes, and returns the byte count
+  inline size_t encodeVarint(uint64_t v, uint8_t *out)
+  {
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+      out[n++] = static_cast<uint8_t>(v) | 0x80;
+      v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+  }
+
+  inline unsigned countTrailingZeros(uint64_t v)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(v));
+#endif
+  }
+
+  // Decodes a varint from at most `avail` bytes at `p`. Returns the number of bytes
+  // consumed, or 0 when the varint is not complete yet. Throws on overlong encodings.
+  inline size_t decodeVarint(const uint8_t *p, size_t avail, uint64_t &value)
+  {
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_X64) || defined(_M_ARM64)
+    // Fast path: locate the terminating byte in one 8 byte load and gather all
+    // 7 bit groups with three shift/mask steps instead of a loop per byte
+    if (avail >= 8)
+    {
+      uint64_t word;
+      std::memcpy(&word, p, 8);
+      uint64_t stops = ~word & 0x8080808080808080ull;
+      if (stops)
+      {
+        size_t n = (countTrailingZeros(stops) >> 3) + 1;
+        uint64_t x = n == 8 ? word : word & ((1ull << (n * 8)) - 1);
+        x &= 0x7f7f7f7f7f7f7f7full;
+        x = ((x & 0x7f007f007f007f00ull) >> 1) | (x & 0x007f007f007f007full);
+        x = ((x & 0x3fff00003fff0000ull) >> 2) | (x & 0x00003fff00003fffull);
+        x = ((x & 0x0fffffff00000000ull) >> 4) | (x & 0x000000000fffffffull);
+        value = x;
+        return n;
+      }
+    }
+#endif
+    uint64_t result = 0;
+    for (size_t n = 0; n < MaxVarintSize; ++n)
+    {
+      if (n == avail)
+        return 0;
+      uint8_t b = p[n];
+      if (n == MaxVarintSize - 1 && b > 1)
+        break;
+      result |= static_cast<uint64_t>(b & 0x7f) << (7 * n);
+      if (!(b & 0x80))
+      {
+        value = result;
+        return n + 1;
+      }
+    }
+    throw std::runtime_error("Malformed varint");
+  }
+
+} // namespace Serialization
+
+#endif // _WIRE_FORMAT_HPP_
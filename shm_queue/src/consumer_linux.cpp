@@ -140,6 +140,13 @@ int main(int argc, char *argv[])
         localQueue.pop();
         lock.unlock();
 
+        // Drop messages damaged in the segment, e.g. by a crashed process
+        if (!Serialization::hasValidChecksum(buf.data(), buf.size()))
+        {
+            std::cerr << "Dropping corrupt message of " << buf.size() << " bytes" << std::endl;
+            continue;
+        }
+
         if (!useData)
         {
             int val;
@@ -154,6 +161,8 @@ int main(int argc, char *argv[])
         {
             Data d;
             Deserializer ds(buf.data(), buf.size());
+            // The frame wraps buf instead of copying it, buf outlives d in this scope
+            ds.setZeroCopy(true);
             d.deserialize(&ds);
 
             std::cout << "Consumed Data: " << d.text
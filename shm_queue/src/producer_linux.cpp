@@ -13,14 +13,45 @@ volatile sig_atomic_t stopRequested = 0;
 ShmQueue *queue = nullptr;
 int shm_fd = -1;
 
+// ==================== Ring sink =====================
+// Serializes straight into the shared memory ring, wrapping at the end of the buffer.
+// The caller must have waited for enough free space before writing.
+class ShmRingSink : public Serialization::Sink
+{
+public:
+    explicit ShmRingSink(ShmQueue *q) : q(q)
+    {
+        cur = q->buffer + q->tail;
+        end = q->buffer + q->capacity;
+    }
+
+    void overflow(const uint8_t *p, size_t n) override
+    {
+        size_t part = end - cur;
+        memcpy(cur, p, part);
+        cur = q->buffer;
+        memcpy(cur, p + part, n - part);
+        cur += n - part;
+    }
+
+    // Publish the written bytes by moving the queue tail
+    void commit()
+    {
+        q->tail = cur - q->buffer;
+        if (q->tail == q->capacity)
+            q->tail = 0;
+    }
+
+private:
+    ShmQueue *q;
+};
+
 // ==================== Generic push =====================
 template <typename T>
 bool push_to_queue(const T &data)
 {
-    Serializer s;
-    s.write(data);
-    auto serializedData = s.data();
-    uint32_t serializedDataSize = s.dataLength();
+    // Payload followed by a CRC32C trailer the consumer verifies
+    uint32_t serializedDataSize = Serialization::serializedSize(data) + Serialization::ChecksumSize;
 
     pthread_mutex_lock(&queue->mutex);
 
@@ -32,6 +63,10 @@ bool push_to_queue(const T &data)
         pthread_cond_wait(&queue->not_full, &queue->mutex);
     }
 
+    // Encoding happens under the lock. If it throws, the length prefix is taken back
+    // and the queue unlocked, so the consumer never sees a partial message.
+    size_t start = queue->tail;
+
     // Write size
     if (queue->tail + sizeof(uint32_t) > queue->capacity)
     {
@@ -48,20 +83,21 @@ bool push_to_queue(const T &data)
             queue->tail = 0;
     }
 
-    // Write data
-    if (queue->tail + serializedDataSize > queue->capacity)
+    // Write data directly into the ring
+    try
     {
-        size_t part = queue->capacity - queue->tail;
-        memcpy(queue->buffer + queue->tail, serializedData, part);
-        memcpy(queue->buffer, serializedData + part, serializedDataSize - part);
-        queue->tail = serializedDataSize - part;
+        ShmRingSink sink(queue);
+        Serializer s(sink);
+        s.beginChecksum();
+        s.write(data);
+        s.writeChecksum();
+        sink.commit();
     }
-    else
+    catch (...)
     {
-        memcpy(queue->buffer + queue->tail, serializedData, serializedDataSize);
-        queue->tail += serializedDataSize;
-        if (queue->tail == queue->capacity)
-            queue->tail = 0;
+        queue->tail = start;
+        pthread_mutex_unlock(&queue->mutex);
+        throw;
     }
 
     pthread_cond_signal(&queue->not_empty);
@@ -3,6 +3,13 @@
 #include <opencv2/opencv.hpp>
 #include "Serialization.hpp"
 
+#include <array>
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using json = nlohmann::json;
 
 using Serialization::Serializer;
@@ -117,3 +124,2049 @@ TEST(Deseralization, tuple_value)
     deserializer.read(tupleData);
     EXPECT_EQ(tuple, tupleData);
 }
+
+struct Sample
+{
+    int id = 0;
+    std::string name;
+    std::vector<double> values;
+
+    void serialize(Serializer *s) const
+    {
+        s->write(id);
+        s->write(name);
+        s->write(values);
+    }
+
+    void deserialize(Deserializer *d)
+    {
+        d->read(id);
+        d->read(name);
+        d->read(values);
+    }
+};
+
+TEST(Seralization, serialized_size_matches_data_length)
+{
+    std::map<std::string, std::vector<int>> map = { { "A", { 1, 2 } }, { "B", {} } };
+    Sample sample{ 7, "sample", { 1.0, 2.0, 3.0 } };
+
+    EXPECT_EQ(Serialization::serializedSize(i), sizeof(i));
+    EXPECT_EQ(Serialization::serializedSize(str), 14);
+
+    Serializer serializer;
+    serializer.write(strVector);
+    EXPECT_EQ(Serialization::serializedSize(strVector), serializer.dataLength());
+
+    Serializer mapSerializer;
+    mapSerializer.write(map);
+    EXPECT_EQ(Serialization::serializedSize(map), mapSerializer.dataLength());
+
+    Serializer tupleSerializer;
+    tupleSerializer.write(tuple);
+    EXPECT_EQ(Serialization::serializedSize(tuple), tupleSerializer.dataLength());
+
+    Serializer customSerializer;
+    customSerializer.write(sample);
+    EXPECT_EQ(Serialization::serializedSize(sample), customSerializer.dataLength());
+}
+
+TEST(Seralization, serialized_size_mat)
+{
+    cv::Mat mat(48, 64, CV_8UC3, cv::Scalar(1, 2, 3));
+    cv::Mat roi = mat(cv::Rect(8, 4, 16, 8));
+
+    Serializer serializer;
+    serializer.write(mat);
+    EXPECT_EQ(Serialization::serializedSize(mat), serializer.dataLength());
+    EXPECT_EQ(serializer.dataLength(), 3 * sizeof(int) + sizeof(size_t) + mat.total() * mat.elemSize());
+
+    Serializer roiSerializer;
+    roiSerializer.write(roi);
+    EXPECT_EQ(Serialization::serializedSize(roi), roiSerializer.dataLength());
+
+    cv::Mat roiData;
+    Deserializer deserializer(roiSerializer.data(), roiSerializer.dataLength());
+    deserializer.read(roiData);
+    ASSERT_EQ(roiData.rows, roi.rows);
+    ASSERT_EQ(roiData.cols, roi.cols);
+    for (int r = 0; r < roi.rows; ++r)
+        EXPECT_EQ(std::memcmp(roiData.ptr(r), roi.ptr(r), roi.cols * roi.elemSize()), 0);
+}
+
+TEST(Deseralization, custom_value)
+{
+    Sample sample{ 7, "sample", { 1.0, 2.0, 3.0 } };
+    Serializer serializer;
+    serializer.write(sample);
+    Sample sampleData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(sampleData);
+    EXPECT_EQ(sample.id, sampleData.id);
+    EXPECT_EQ(sample.name, sampleData.name);
+    EXPECT_EQ(sample.values, sampleData.values);
+}
+
+TEST(Seralization, reset_keeps_capacity)
+{
+    Serializer serializer;
+    serializer.write(strVector);
+    size_t capacity = serializer.capacity();
+    const uint8_t *storage = serializer.data();
+
+    serializer.reset();
+    EXPECT_EQ(serializer.dataLength(), 0);
+    EXPECT_EQ(serializer.capacity(), capacity);
+
+    serializer.write(strVector);
+    EXPECT_EQ(serializer.data(), storage);
+    std::vector<std::string> strVectorData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(strVectorData);
+    EXPECT_EQ(strVector, strVectorData);
+}
+
+TEST(Seralization, release_and_adopt)
+{
+    Serializer serializer;
+    serializer.write(str);
+    std::vector<uint8_t> released = serializer.release();
+    EXPECT_EQ(serializer.dataLength(), 0);
+    EXPECT_EQ(released.size(), 14);
+
+    std::string strData;
+    Deserializer deserializer(released);
+    deserializer.read(strData);
+    EXPECT_EQ(str, strData);
+
+    released.reserve(1024);
+    const uint8_t *storage = released.data();
+    Serializer adopting(std::move(released));
+    EXPECT_EQ(adopting.dataLength(), 0);
+    EXPECT_GE(adopting.capacity(), 1024);
+    adopting.write(strVector);
+    EXPECT_EQ(adopting.data(), storage);
+}
+
+TEST(Seralization, span_sink)
+{
+    Serializer reference;
+    reference.write(strVector);
+
+    std::vector<uint8_t> storage(reference.dataLength());
+    Serialization::SpanSink sink(storage.data(), storage.size());
+    Serializer serializer(sink);
+    serializer.write(strVector);
+    EXPECT_EQ(sink.size(), reference.dataLength());
+    EXPECT_EQ(std::memcmp(storage.data(), reference.data(), storage.size()), 0);
+
+    EXPECT_THROW(serializer.write(str), std::runtime_error);
+}
+
+TEST(Seralization, callback_sink)
+{
+    std::map<std::string, std::vector<int>> map = { { "A", { 1, 2, 3 } }, { "LONG KEY STRING", { 4 } } };
+    Serializer reference;
+    reference.write(map);
+
+    std::vector<uint8_t> collected;
+    size_t calls = 0;
+    {
+        Serialization::CallbackSink sink([&](const uint8_t *p, size_t n) {
+            collected.insert(collected.end(), p, p + n);
+            ++calls;
+        }, 8);
+        Serializer serializer(sink);
+        serializer.write(map);
+        serializer.flush();
+    }
+    EXPECT_GT(calls, 1);
+    ASSERT_EQ(collected.size(), reference.dataLength());
+    EXPECT_EQ(std::memcmp(collected.data(), reference.data(), collected.size()), 0);
+}
+
+TEST(Seralization, ostream_sink)
+{
+    std::map<std::string, std::vector<int>> map = { { "A", { 1, 2, 3 } }, { "LONG KEY STRING", { 4 } } };
+    std::string big(1000, 'b');
+    Serializer reference;
+    reference.write(map);
+    reference.write(big);
+
+    std::ostringstream os;
+    {
+        Serialization::OStreamSink sink(os, 16);
+        Serializer serializer(sink);
+        serializer.write(map);
+        serializer.write(big);
+    }
+    std::string contents = os.str();
+    ASSERT_EQ(contents.size(), reference.dataLength());
+    EXPECT_EQ(std::memcmp(contents.data(), reference.data(), contents.size()), 0);
+
+    // Staging refills hand bytes to the stream without syncing it
+    struct CountingBuf : std::stringbuf
+    {
+        int syncs = 0;
+        int sync() override
+        {
+            ++syncs;
+            return std::stringbuf::sync();
+        }
+    } buf;
+    std::ostream counted(&buf);
+    {
+        Serialization::OStreamSink sink(counted, 16);
+        Serializer serializer(sink);
+        serializer.write(map);
+        serializer.write(big);
+        EXPECT_EQ(buf.syncs, 0);
+        serializer.flush();
+        EXPECT_EQ(buf.syncs, 1);
+    }
+    EXPECT_EQ(buf.str(), contents);
+}
+
+TEST(Seralization, buffered_sink_blob_bypass)
+{
+    std::string big(1000, 'b');
+    std::vector<double> values(200, 2.5);
+    std::vector<const uint8_t *> puts;
+    size_t total = 0;
+    {
+        Serialization::CallbackSink sink([&](const uint8_t *p, size_t n) {
+            puts.push_back(p);
+            total += n;
+        }, 64);
+        Serializer serializer(sink);
+        serializer.write(i);
+        serializer.write(big);
+        serializer.write(values);
+        serializer.flush();
+    }
+    EXPECT_EQ(total, sizeof(int) + 2 * sizeof(uint64_t) + big.size() + values.size() * sizeof(double));
+    EXPECT_NE(std::find(puts.begin(), puts.end(), reinterpret_cast<const uint8_t *>(big.data())), puts.end());
+    EXPECT_NE(std::find(puts.begin(), puts.end(), reinterpret_cast<const uint8_t *>(values.data())), puts.end());
+}
+
+#ifndef _WIN32
+TEST(Seralization, fd_sink)
+{
+    Serializer reference;
+    reference.write(tuple);
+    reference.write(strList);
+
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    int fd = fileno(file);
+    {
+        Serialization::FdSink sink(fd, 16);
+        Serializer serializer(sink);
+        serializer.write(tuple);
+        serializer.write(strList);
+    }
+    std::vector<uint8_t> contents(reference.dataLength() + 1);
+    ASSERT_EQ(pread(fd, contents.data(), contents.size(), 0), (ssize_t)reference.dataLength());
+    EXPECT_EQ(std::memcmp(contents.data(), reference.data(), reference.dataLength()), 0);
+    fclose(file);
+}
+
+TEST(Seralization, gather_sink)
+{
+    std::string big(5000, 'g');
+    std::vector<float> floats(2000, 1.5f);
+    cv::Mat mat(64, 64, CV_8UC1, cv::Scalar(7));
+
+    Serializer reference;
+    Serialization::GatherSink sink(1024);
+    Serializer serializer(sink);
+    uint32_t crcs[2];
+    int k = 0;
+    for (Serializer *s : {&reference, &serializer})
+    {
+        s->write(i);
+        s->beginChecksum();
+        s->write(big);
+        s->write(str);
+        s->write(floats);
+        s->write(mat);
+        crcs[k++] = s->writeChecksum();
+    }
+    EXPECT_EQ(crcs[0], crcs[1]);
+
+    // Large payloads are referenced in place, the rest is copied inline
+    std::vector<const uint8_t *> external;
+    for (const Serialization::GatherSink::Segment &segment : sink.segments())
+        external.push_back(segment.data);
+    EXPECT_NE(std::find(external.begin(), external.end(), reinterpret_cast<const uint8_t *>(big.data())), external.end());
+    EXPECT_NE(std::find(external.begin(), external.end(), reinterpret_cast<const uint8_t *>(floats.data())), external.end());
+    EXPECT_NE(std::find(external.begin(), external.end(), mat.data), external.end());
+
+    ASSERT_EQ(sink.size(), reference.dataLength());
+    std::vector<uint8_t> gathered(sink.size());
+    sink.copyTo(gathered.data());
+    EXPECT_EQ(std::memcmp(gathered.data(), reference.data(), gathered.size()), 0);
+
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    int fd = fileno(file);
+    sink.writeTo(fd);
+    std::vector<uint8_t> contents(reference.dataLength() + 1);
+    ASSERT_EQ(pread(fd, contents.data(), contents.size(), 0), (ssize_t)reference.dataLength());
+    EXPECT_EQ(std::memcmp(contents.data(), reference.data(), reference.dataLength()), 0);
+    fclose(file);
+
+    sink.clear();
+    serializer.write(str);
+    EXPECT_EQ(sink.size(), sizeof(uint64_t) + str.size());
+}
+#endif
+
+TEST(Seralization, bulk_vector_layout)
+{
+    std::vector<int> ints(1000);
+    for (size_t k = 0; k < ints.size(); ++k)
+        ints[k] = (int)k * 3;
+    Serializer serializer;
+    serializer.write(ints);
+    ASSERT_EQ(serializer.dataLength(), sizeof(uint64_t) + ints.size() * sizeof(int));
+    uint64_t len;
+    memcpy(&len, serializer.data(), sizeof(len));
+    EXPECT_EQ(len, ints.size());
+    EXPECT_EQ(std::memcmp(serializer.data() + sizeof(len), ints.data(), ints.size() * sizeof(int)), 0);
+
+    std::vector<int> intsData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(intsData);
+    EXPECT_EQ(ints, intsData);
+}
+
+TEST(Deseralization, bulk_contiguous_values)
+{
+    std::vector<float> floats = { 1.5f, -2.25f, 3.0f };
+    std::u16string wide = u"wide string";
+    std::array<int, 4> ints = { 1, 2, 3, 4 };
+    std::array<std::string, 2> strs = { "A", "BC" };
+
+    Serializer serializer;
+    serializer.write(floats);
+    serializer.write(wide);
+    serializer.write(ints);
+    serializer.write(strs);
+    EXPECT_EQ(Serialization::serializedSize(wide), sizeof(uint64_t) + wide.size() * sizeof(char16_t));
+
+    std::vector<float> floatsData;
+    std::u16string wideData;
+    std::array<int, 4> intsData;
+    std::array<std::string, 2> strsData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(floatsData);
+    deserializer.read(wideData);
+    deserializer.read(intsData);
+    deserializer.read(strsData);
+    EXPECT_EQ(floats, floatsData);
+    EXPECT_EQ(wide, wideData);
+    EXPECT_EQ(ints, intsData);
+    EXPECT_EQ(strs, strsData);
+}
+
+TEST(Deseralization, bulk_vector_underflow)
+{
+    std::vector<double> doubles = { 1.0, 2.0, 3.0 };
+    Serializer serializer;
+    serializer.write(doubles);
+
+    std::vector<double> doublesData = { 9.0 };
+    Deserializer deserializer(serializer.data(), serializer.dataLength() - 1);
+    EXPECT_THROW(deserializer.read(doublesData), std::runtime_error);
+
+    uint64_t hugeLength = ~0ull / 2;
+    Deserializer corrupt(reinterpret_cast<const uint8_t *>(&hugeLength), sizeof(hugeLength));
+    EXPECT_THROW(corrupt.read(doublesData), std::runtime_error);
+}
+
+TEST(Deseralization, unordered_map_value)
+{
+    std::unordered_map<std::string, std::vector<int>> map;
+    for (int k = 0; k < 1000; ++k)
+        map[std::to_string(k)] = { k, k + 1 };
+    Serializer serializer;
+    serializer.write(map);
+
+    std::unordered_map<std::string, std::vector<int>> mapData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(mapData);
+    EXPECT_EQ(map, mapData);
+    EXPECT_GE(mapData.bucket_count() * mapData.max_load_factor(), map.size());
+}
+
+TEST(Deseralization, ordered_map_value)
+{
+    std::map<int, std::string> map;
+    std::multiset<int> multiset;
+    for (int k = 0; k < 1000; ++k)
+    {
+        map[k * 7 % 1000] = std::to_string(k);
+        multiset.insert(k % 10);
+    }
+    Serializer serializer;
+    serializer.write(map);
+    serializer.write(multiset);
+
+    std::map<int, std::string> mapData = { { -1, "stale" } };
+    std::multiset<int> multisetData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(mapData);
+    deserializer.read(multisetData);
+    EXPECT_EQ(map, mapData);
+    EXPECT_EQ(multiset, multisetData);
+}
+
+TEST(Deseralization, string_view_value)
+{
+    Serializer serializer;
+    serializer.write(str);
+    serializer.write(strVector);
+
+    std::string_view view;
+    std::vector<std::string_view> views;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(view);
+    deserializer.read(views);
+    EXPECT_EQ(view, str);
+    EXPECT_EQ((const uint8_t *)view.data(), serializer.data() + sizeof(uint64_t));
+    ASSERT_EQ(views.size(), strVector.size());
+    for (size_t k = 0; k < views.size(); ++k)
+    {
+        EXPECT_EQ(views[k], strVector[k]);
+        EXPECT_GE((const uint8_t *)views[k].data(), serializer.data());
+        EXPECT_LT((const uint8_t *)views[k].data(), serializer.data() + serializer.dataLength());
+    }
+
+    Serializer viewSerializer;
+    viewSerializer.write(views);
+    EXPECT_EQ(viewSerializer.dataLength(), Serialization::serializedSize(strVector));
+}
+
+TEST(Deseralization, span_value)
+{
+    std::vector<float> floats = { 1.5f, -2.25f, 3.0f };
+    std::map<std::string, std::vector<int>> map = { { "A", { 1, 2 } }, { "B", { 3 } } };
+    Serializer serializer;
+    serializer.write(str);
+    serializer.write(floats);
+    serializer.write(map);
+
+    std::string_view view;
+    Serialization::Span<float> span;
+    std::map<std::string_view, Serialization::Span<int>> mapView;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(view);
+    deserializer.read(span);
+    deserializer.read(mapView);
+
+    ASSERT_EQ(span.size(), floats.size());
+    EXPECT_EQ(std::vector<float>(span.begin(), span.end()), floats);
+    EXPECT_EQ(span[1], floats[1]);
+    EXPECT_EQ(span.bytes(), serializer.data() + 14 + sizeof(uint64_t));
+    EXPECT_EQ(span.aligned(), span.data() != nullptr);
+    ASSERT_EQ(mapView.size(), 2);
+    EXPECT_EQ(mapView["A"][1], 2);
+    EXPECT_EQ(mapView["B"][0], 3);
+
+    Serializer spanSerializer;
+    spanSerializer.write(Serialization::Span<float>(floats.data(), floats.size()));
+    EXPECT_EQ(spanSerializer.dataLength(), Serialization::serializedSize(floats));
+
+    // Byte views read back as the bytes of a std::vector<uint8_t>
+    std::vector<uint8_t> blob = { 1, 2, 3, 250 };
+    Serializer blobSerializer;
+    blobSerializer.write(Serialization::Span<uint8_t>(blob.data(), blob.size()));
+    Serialization::Span<uint8_t> blobView;
+    Deserializer blobDeserializer(blobSerializer.data(), blobSerializer.dataLength());
+    blobDeserializer.read(blobView);
+    EXPECT_EQ(std::vector<uint8_t>(blobView.begin(), blobView.end()), blob);
+    EXPECT_EQ(blobView.data(), blobSerializer.data() + sizeof(uint64_t));
+}
+
+TEST(Deseralization, mat_zero_copy)
+{
+    cv::Mat bytes(48, 64, CV_8UC3, cv::Scalar(1, 2, 3));
+    cv::Mat doubles(4, 4, CV_64FC1, cv::Scalar(2.5));
+    Serializer serializer;
+    serializer.write(doubles);
+    serializer.write(bytes);
+    const uint8_t *begin = serializer.data();
+    const uint8_t *end = begin + serializer.dataLength();
+
+    cv::Mat bytesData, doublesData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setZeroCopy(true);
+    deserializer.read(doublesData);
+    deserializer.read(bytesData);
+
+    // 8 bit pixels are wrapped in place
+    EXPECT_TRUE(bytesData.data >= begin && bytesData.data < end);
+    EXPECT_EQ(std::memcmp(bytesData.data, bytes.data, bytes.total() * bytes.elemSize()), 0);
+    // 64 bit pixels are not aligned after the 20 byte header and are copied
+    EXPECT_FALSE(doublesData.data >= begin && doublesData.data < end);
+    EXPECT_EQ(doublesData.at<double>(3, 3), 2.5);
+}
+
+TEST(Deseralization, mat_view_keeps_buffer_alive)
+{
+    cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(4, 5, 6));
+    Serializer serializer;
+    serializer.write(frame);
+    auto buffer = std::make_shared<const std::vector<uint8_t>>(serializer.release());
+    std::weak_ptr<const std::vector<uint8_t>> weak = buffer;
+
+    Serialization::MatView view;
+    {
+        Deserializer deserializer(buffer);
+        deserializer.read(view);
+    }
+    buffer.reset();
+    ASSERT_FALSE(weak.expired());
+    EXPECT_EQ(view.mat.data, weak.lock()->data() + 20);
+    EXPECT_EQ(std::memcmp(view.mat.data, frame.data, frame.total() * frame.elemSize()), 0);
+
+    view = Serialization::MatView();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(Seralization, varint_encoding)
+{
+    const uint64_t values[] = { 0, 1, 127, 128, 300, 16383, 16384, (1ull << 35) + 5, (1ull << 56) - 1, 1ull << 56, 1ull << 63, ~0ull };
+    for (uint64_t v : values)
+    {
+        uint8_t buf[16] = {};
+        size_t n = Serialization::encodeVarint(v, buf);
+        EXPECT_EQ(n, Serialization::varintSize(v));
+        uint64_t decoded = 0;
+        // Short input takes the byte loop, padded input the 8 byte fast path
+        EXPECT_EQ(Serialization::decodeVarint(buf, n, decoded), n);
+        EXPECT_EQ(decoded, v);
+        decoded = 0;
+        EXPECT_EQ(Serialization::decodeVarint(buf, sizeof(buf), decoded), n);
+        EXPECT_EQ(decoded, v);
+        if (n > 1)
+        {
+            EXPECT_EQ(Serialization::decodeVarint(buf, n - 1, decoded), 0);
+        }
+    }
+    const int64_t signedValues[] = { 0, -1, 1, -64, 64, INT64_MIN, INT64_MAX };
+    for (int64_t v : signedValues)
+        EXPECT_EQ(Serialization::zigzagDecode(Serialization::zigzagEncode(v)), v);
+    EXPECT_EQ(Serialization::zigzagEncode(-1), 1);
+
+    uint8_t overlong[11];
+    std::memset(overlong, 0xff, sizeof(overlong));
+    uint64_t decoded;
+    EXPECT_THROW(Serialization::decodeVarint(overlong, sizeof(overlong), decoded), std::runtime_error);
+}
+
+TEST(Deseralization, compact_format_value)
+{
+    std::vector<std::pair<std::string, int>> table = { { "A", 1 }, { "B", -2 }, { "C", 300 } };
+    std::vector<int> ints = { 0, -1, 70000, INT32_MIN };
+    std::vector<uint16_t> shorts = { 1, 2, 65535 };
+    std::map<std::string, std::vector<int64_t>> map = { { "A", { INT64_MAX, -5 } } };
+    Sample sample{ -7, "sample", { 1.0, 2.0 } };
+
+    Serializer fixed;
+    fixed.write(table);
+    Serializer serializer;
+    serializer.setFormat(Serialization::WireFormat::compact());
+    serializer.write(table);
+    serializer.write(ints);
+    serializer.write(shorts);
+    serializer.write(map);
+    serializer.write(sample);
+    EXPECT_EQ(Serialization::serializedSize(table, Serialization::WireFormat::compact()), 11);
+    EXPECT_LT(Serialization::serializedSize(table, Serialization::WireFormat::compact()), fixed.dataLength());
+
+    std::vector<std::pair<std::string, int>> tableData;
+    std::vector<int> intsData;
+    std::vector<uint16_t> shortsData;
+    std::map<std::string, std::vector<int64_t>> mapData;
+    Sample sampleData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setFormat(Serialization::WireFormat::compact());
+    deserializer.read(tableData);
+    deserializer.read(intsData);
+    deserializer.read(shortsData);
+    deserializer.read(mapData);
+    deserializer.read(sampleData);
+    EXPECT_EQ(table, tableData);
+    EXPECT_EQ(ints, intsData);
+    EXPECT_EQ(shorts, shortsData);
+    EXPECT_EQ(map, mapData);
+    EXPECT_EQ(sample.id, sampleData.id);
+    EXPECT_EQ(sample.values, sampleData.values);
+
+    // Values that do not fit the type being read are rejected
+    Serializer wide;
+    wide.setFormat(Serialization::WireFormat::compact());
+    wide.write(uint32_t(70000));
+    wide.write(int32_t(-40000));
+    wide.write(int32_t(-32768));
+    Deserializer narrow(wide.data(), wide.dataLength());
+    narrow.setFormat(Serialization::WireFormat::compact());
+    EXPECT_THROW(narrow.read<uint16_t>(), std::runtime_error);
+    EXPECT_THROW(narrow.read<int16_t>(), std::runtime_error);
+    EXPECT_EQ(narrow.read<int16_t>(), -32768);
+}
+
+TEST(Seralization, big_endian_layout)
+{
+    Serialization::WireFormat big;
+    big.byteOrder = Serialization::ByteOrder::Big;
+    Serializer serializer;
+    serializer.setFormat(big);
+    serializer.write(int32_t(0x01020304));
+    serializer.write(std::vector<uint16_t>{ 0x0a0b });
+    const uint8_t expected[] = { 1, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 1, 0x0a, 0x0b };
+    ASSERT_EQ(serializer.dataLength(), sizeof(expected));
+    EXPECT_EQ(std::memcmp(serializer.data(), expected, sizeof(expected)), 0);
+
+    // The host order mode is plain memory
+    Serialization::WireFormat host;
+    host.byteOrder = Serialization::hostIsLittleEndian() ? Serialization::ByteOrder::Little : Serialization::ByteOrder::Big;
+    std::vector<double> doubles = { 1.0, 2.0 };
+    Serializer native;
+    native.write(doubles);
+    Serializer fixed;
+    fixed.setFormat(host);
+    fixed.write(doubles);
+    ASSERT_EQ(native.dataLength(), fixed.dataLength());
+    EXPECT_EQ(std::memcmp(native.data(), fixed.data(), native.dataLength()), 0);
+}
+
+TEST(Deseralization, swapped_byte_order_value)
+{
+    Serialization::WireFormat swapped;
+    swapped.byteOrder = Serialization::hostIsLittleEndian() ? Serialization::ByteOrder::Big : Serialization::ByteOrder::Little;
+
+    // Odd sizes exercise the vector kernels and their scalar tails
+    std::vector<uint16_t> shorts(1001);
+    std::vector<int32_t> ints(517);
+    std::vector<double> doubles(263);
+    for (size_t k = 0; k < shorts.size(); ++k)
+        shorts[k] = (uint16_t)(k * 131);
+    for (size_t k = 0; k < ints.size(); ++k)
+        ints[k] = (int32_t)(k * 2654435761u);
+    for (size_t k = 0; k < doubles.size(); ++k)
+        doubles[k] = k * 0.37 - 11.0;
+    std::map<std::string, float> map = { { "A", 1.5f }, { "B", -2.0f } };
+    cv::Mat mat(17, 23, CV_32FC3, cv::Scalar(1.5, -2.5, 3.25));
+    cv::Mat roi = mat(cv::Rect(2, 3, 7, 5));
+
+    Serializer serializer;
+    serializer.setFormat(swapped);
+    serializer.write(shorts);
+    serializer.write(ints);
+    serializer.write(doubles);
+    serializer.write(map);
+    serializer.write(mat);
+    serializer.write(roi);
+
+    Serializer native;
+    native.write(ints);
+    EXPECT_NE(std::memcmp(serializer.data() + Serialization::serializedSize(shorts), native.data(), native.dataLength()), 0);
+
+    std::vector<uint16_t> shortsData;
+    std::vector<int32_t> intsData;
+    std::vector<double> doublesData;
+    std::map<std::string, float> mapData;
+    cv::Mat matData, roiData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setFormat(swapped);
+    deserializer.setZeroCopy(true);
+    deserializer.read(shortsData);
+    deserializer.read(intsData);
+    deserializer.read(doublesData);
+    deserializer.read(mapData);
+    deserializer.read(matData);
+    deserializer.read(roiData);
+    EXPECT_EQ(shorts, shortsData);
+    EXPECT_EQ(ints, intsData);
+    EXPECT_EQ(doubles, doublesData);
+    EXPECT_EQ(map, mapData);
+    EXPECT_EQ(std::memcmp(matData.data, mat.data, mat.total() * mat.elemSize()), 0);
+    for (int r = 0; r < roi.rows; ++r)
+        EXPECT_EQ(std::memcmp(roiData.ptr(r), roi.ptr(r), roi.cols * roi.elemSize()), 0);
+}
+
+// Aggregate without a portable byte order
+struct PlainPair
+{
+    int32_t a;
+    int32_t b;
+};
+
+TEST(Deseralization, swapped_byte_order_aggregates)
+{
+    Serialization::WireFormat big;
+    big.byteOrder = Serialization::ByteOrder::Big;
+
+    // std::array is reordered element by element, like the scalars it holds
+    std::array<int32_t, 1> one = { 1 };
+    std::vector<std::array<uint16_t, 2>> pairs = { { 1, 2 }, { 3, 0x1234 } };
+    Serializer serializer;
+    serializer.setFormat(big);
+    serializer.write(one);
+    serializer.write(pairs);
+    const uint8_t expected[] = { 0, 0, 0, 1 };
+    EXPECT_EQ(std::memcmp(serializer.data(), expected, sizeof(expected)), 0);
+    EXPECT_EQ(serializer.data()[serializer.dataLength() - 2], 0x12);
+
+    std::array<int32_t, 1> oneData;
+    std::vector<std::array<uint16_t, 2>> pairsData;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setFormat(big);
+    deserializer.read(oneData);
+    deserializer.read(pairsData);
+    EXPECT_EQ(oneData, one);
+    EXPECT_EQ(pairsData, pairs);
+
+    // Other aggregates cannot be reordered and are rejected instead of written raw
+    Serialization::WireFormat swapped;
+    swapped.byteOrder = Serialization::hostIsLittleEndian() ? Serialization::ByteOrder::Big : Serialization::ByteOrder::Little;
+    std::vector<PlainPair> plain(2);
+    Serializer plainSerializer;
+    plainSerializer.setFormat(swapped);
+    EXPECT_THROW(plainSerializer.write(plain), std::runtime_error);
+    EXPECT_THROW(plainSerializer.write(plain[0]), std::runtime_error);
+    Serializer nativeSerializer;
+    nativeSerializer.write(plain);
+    Deserializer plainDeserializer(nativeSerializer.data(), nativeSerializer.dataLength());
+    plainDeserializer.setFormat(swapped);
+    EXPECT_THROW(plainDeserializer.read(plain), std::runtime_error);
+}
+
+TEST(Seralization, swap_copy_kernels)
+{
+    std::vector<uint8_t> src(1000), dst(1000), ref(1000);
+    for (size_t k = 0; k < src.size(); ++k)
+        src[k] = (uint8_t)(k * 7 + 1);
+    for (size_t width : { 2, 4, 8 })
+    {
+        size_t count = 997 / width;
+        Serialization::swapCopy(dst.data() + 1, src.data() + 3, count, width);
+        Serialization::swapCopyScalar(ref.data() + 1, src.data() + 3, count, width);
+        EXPECT_EQ(std::memcmp(dst.data() + 1, ref.data() + 1, count * width), 0);
+    }
+}
+
+// Two versions of one tagged record, version 2 adds a field
+struct RecordV1
+{
+    int id = 0;
+    std::string name;
+
+    void serialize(Serializer *s) const
+    {
+        s->writeField(1, id);
+        s->writeField(2, name);
+        s->endFields();
+    }
+
+    void deserialize(Deserializer *d)
+    {
+        d->readFields([this](Deserializer &d, uint32_t tag) {
+            switch (tag)
+            {
+            case 1: d.read(id); break;
+            case 2: d.read(name); break;
+            }
+        });
+    }
+};
+
+struct RecordV2
+{
+    int id = 0;
+    std::string name;
+    std::vector<double> samples;
+    RecordV1 parent;
+
+    void serialize(Serializer *s) const
+    {
+        s->writeField(1, id);
+        s->writeField(2, name);
+        s->writeField(3, samples);
+        s->writeField(4, parent);
+        s->endFields();
+    }
+
+    void deserialize(Deserializer *d)
+    {
+        d->readFields([this](Deserializer &d, uint32_t tag) {
+            switch (tag)
+            {
+            case 1: d.read(id); break;
+            case 2: d.read(name); break;
+            case 3: d.read(samples); break;
+            case 4: d.read(parent); break;
+            }
+        });
+    }
+};
+
+TEST(Deseralization, tagged_fields_evolution)
+{
+    RecordV2 v2;
+    v2.id = 42;
+    v2.name = "second";
+    v2.samples.assign(1000, 0.5);
+    v2.parent.id = 7;
+    v2.parent.name = "first";
+
+    Serializer serializer;
+    serializer.write(v2);
+    serializer.write(i);
+
+    // An old reader skips the fields it does not know
+    RecordV1 old;
+    int after = 0;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(old);
+    deserializer.read(after);
+    EXPECT_EQ(old.id, 42);
+    EXPECT_EQ(old.name, "second");
+    EXPECT_EQ(after, i);
+
+    // A new reader of old data keeps its defaults
+    Serializer oldSerializer;
+    oldSerializer.write(v2.parent);
+    RecordV2 fromOld;
+    Deserializer oldDeserializer(oldSerializer.data(), oldSerializer.dataLength());
+    oldDeserializer.read(fromOld);
+    EXPECT_EQ(fromOld.id, 7);
+    EXPECT_EQ(fromOld.name, "first");
+    EXPECT_TRUE(fromOld.samples.empty());
+
+    RecordV2 roundTrip;
+    Deserializer fullDeserializer(serializer.data(), serializer.dataLength());
+    fullDeserializer.read(roundTrip);
+    EXPECT_EQ(roundTrip.samples, v2.samples);
+    EXPECT_EQ(roundTrip.parent.name, "first");
+}
+
+// Chain of tagged structs that counts its serialize() calls
+int nestedSerializeCalls = 0;
+
+template <int Depth>
+struct NestedTagged
+{
+    NestedTagged<Depth - 1> child;
+
+    void serialize(Serializer *s) const
+    {
+        ++nestedSerializeCalls;
+        s->writeField(1, child);
+        s->endFields();
+    }
+};
+
+template <>
+struct NestedTagged<0>
+{
+    int value = 0;
+
+    void serialize(Serializer *s) const
+    {
+        ++nestedSerializeCalls;
+        s->writeField(1, value);
+        s->endFields();
+    }
+};
+
+TEST(Seralization, tagged_fields_nested_size)
+{
+    // Measuring visits every struct once
+    NestedTagged<16> chain;
+    nestedSerializeCalls = 0;
+    size_t size = Serialization::serializedSize(chain);
+    EXPECT_EQ(nestedSerializeCalls, 17);
+
+    std::vector<NestedTagged<3>> items(5);
+    nestedSerializeCalls = 0;
+    Serialization::serializedSize(Serialization::indexed(items));
+    EXPECT_EQ(nestedSerializeCalls, 20);
+
+    Serialization::Lazy<NestedTagged<3>> lazy = NestedTagged<3>();
+    nestedSerializeCalls = 0;
+    Serialization::serializedSize(lazy);
+    EXPECT_EQ(nestedSerializeCalls, 4);
+
+    // Writing measures each field once, not once per enclosing level
+    nestedSerializeCalls = 0;
+    Serializer serializer;
+    serializer.write(chain);
+    EXPECT_EQ(serializer.dataLength(), size);
+    EXPECT_LE(nestedSerializeCalls, 17 * 18);
+}
+
+TEST(Deseralization, tagged_fields_confined)
+{
+    Serializer serializer;
+    serializer.writeField(1, i);
+    serializer.endFields();
+
+    std::string overread;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    EXPECT_THROW(deserializer.readFields([&](Deserializer &d, uint32_t) { d.read(overread); }), std::runtime_error);
+    EXPECT_THROW(serializer.writeField(0, i), std::invalid_argument);
+}
+
+// Trivially copyable, but encoded with its own tagged fields
+struct TaggedPoint
+{
+    int32_t x = 0;
+    int32_t y = 0;
+
+    void serialize(Serializer *s) const
+    {
+        s->writeField(1, x);
+        s->writeField(2, y);
+        s->endFields();
+    }
+
+    void deserialize(Deserializer *d)
+    {
+        d->readFields([this](Deserializer &d, uint32_t tag) {
+            switch (tag)
+            {
+            case 1: d.read(x); break;
+            case 2: d.read(y); break;
+            }
+        });
+    }
+};
+
+TEST(Deseralization, custom_pod_elements)
+{
+    std::vector<TaggedPoint> points(3);
+    std::array<TaggedPoint, 2> pair;
+    for (int k = 0; k < 3; ++k)
+        points[k] = {k, -k};
+    pair[1] = {5, 6};
+
+    Serializer serializer;
+    serializer.write(points);
+    serializer.write(pair);
+    // Every element carries its tags, not its raw 8 bytes
+    EXPECT_EQ(serializer.dataLength(), Serialization::serializedSize(points[0]) * 5 + sizeof(uint64_t));
+
+    std::vector<TaggedPoint> points2;
+    std::array<TaggedPoint, 2> pair2;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(points2);
+    deserializer.read(pair2);
+    ASSERT_EQ(points2.size(), 3u);
+    EXPECT_EQ(points2[2].x, 2);
+    EXPECT_EQ(points2[2].y, -2);
+    EXPECT_EQ(pair2[1].x, 5);
+    EXPECT_EQ(pair2[1].y, 6);
+}
+
+TEST(Deseralization, indexed_sequence_random_access)
+{
+    std::vector<std::string> names = {"alpha", "beta", "", "delta epsilon"};
+    for (const auto &format : {Serialization::WireFormat(), Serialization::WireFormat::compact()})
+    {
+        Serializer serializer;
+        serializer.setFormat(format);
+        serializer.write(Serialization::indexed(names));
+        serializer.write(i);
+
+        Serialization::IndexedSequence<std::string> view;
+        int after = 0;
+        Deserializer deserializer(serializer.data(), serializer.dataLength());
+        deserializer.setFormat(format);
+        deserializer.read(view);
+        deserializer.read(after);
+        ASSERT_EQ(view.size(), names.size());
+        EXPECT_EQ(view.at(3), names[3]);
+        EXPECT_EQ(view.at(0), names[0]);
+        EXPECT_EQ(view.at(2), names[2]);
+        EXPECT_THROW(view.at(4), std::out_of_range);
+        EXPECT_EQ(after, i);
+    }
+}
+
+TEST(Deseralization, indexed_map_lookup)
+{
+    std::map<std::string, std::vector<int>> table;
+    for (int k = 0; k < 50; ++k)
+        table["key" + std::to_string(k)] = std::vector<int>(k % 5, k);
+
+    Serialization::WireFormat big;
+    big.byteOrder = Serialization::ByteOrder::Big;
+    for (const auto &format : {Serialization::WireFormat(), Serialization::WireFormat::compact(), big})
+    {
+        Serializer serializer;
+        serializer.setFormat(format);
+        serializer.write(Serialization::indexed(table));
+
+        Serialization::IndexedMap<std::string, std::vector<int>> view;
+        Deserializer deserializer(serializer.data(), serializer.dataLength());
+        deserializer.setFormat(format);
+        deserializer.read(view);
+        ASSERT_EQ(view.size(), table.size());
+        for (const auto &e : table)
+        {
+            std::vector<int> value;
+            ASSERT_TRUE(view.find(e.first, value));
+            EXPECT_EQ(value, e.second);
+        }
+        std::vector<int> missing;
+        EXPECT_FALSE(view.find("key50", missing));
+        EXPECT_FALSE(view.contains("key"));
+    }
+
+    std::map<int, int> empty;
+    Serializer serializer;
+    serializer.write(Serialization::indexed(empty));
+    Serialization::IndexedMap<int, int> view;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(view);
+    EXPECT_FALSE(view.contains(1));
+}
+
+TEST(Deseralization, indexed_corrupt_offsets)
+{
+    std::vector<std::string> names = {"alpha", "beta"};
+    Serializer serializer;
+    serializer.write(Serialization::indexed(names));
+    std::vector<uint8_t> bytes(serializer.data(), serializer.data() + serializer.dataLength());
+
+    // Second element offset points past the payload
+    uint32_t bad = 1000;
+    std::memcpy(&bytes[sizeof(uint64_t) + 1 + 4 + 4], &bad, sizeof(bad));
+    Serialization::IndexedSequence<std::string> view;
+    Deserializer deserializer(bytes);
+    deserializer.read(view);
+    EXPECT_THROW(view.at(1), std::runtime_error);
+
+    bytes[sizeof(uint64_t)] = 3;
+    Deserializer badWidth(bytes);
+    EXPECT_THROW(badWidth.read(view), std::runtime_error);
+}
+
+struct LazyRecord
+{
+    int id;
+    Serialization::Lazy<std::vector<std::string>> payload;
+    std::string name;
+
+    void serialize(Serializer *s) const
+    {
+        s->write(id);
+        s->write(payload);
+        s->write(name);
+    }
+
+    void deserialize(Deserializer *d)
+    {
+        d->read(id);
+        d->read(payload);
+        d->read(name);
+    }
+};
+
+TEST(Deseralization, lazy_decode_on_access)
+{
+    LazyRecord record;
+    record.id = i;
+    record.payload = std::vector<std::string>{"one", "two", "three"};
+    record.name = "lazy";
+
+    Serializer serializer;
+    serializer.write(record);
+
+    LazyRecord result;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(result);
+    EXPECT_EQ(result.id, i);
+    EXPECT_EQ(result.name, "lazy");
+    EXPECT_FALSE(result.payload.loaded());
+    EXPECT_EQ(result.payload.encodedSize(), Serialization::serializedSize(*record.payload));
+
+    // Undecoded bytes are copied through unchanged
+    Serializer copy;
+    copy.write(result);
+    ASSERT_EQ(copy.dataLength(), serializer.dataLength());
+    EXPECT_EQ(std::memcmp(copy.data(), serializer.data(), copy.dataLength()), 0);
+    EXPECT_FALSE(result.payload.loaded());
+
+    const LazyRecord &view = result;
+    EXPECT_EQ(view.payload->size(), 3u);
+    EXPECT_EQ((*view.payload)[2], "three");
+    EXPECT_TRUE(result.payload.loaded());
+
+    // Re-encoded when the output format differs
+    Serializer compact;
+    compact.setFormat(Serialization::WireFormat::compact());
+    compact.write(result);
+    LazyRecord fromCompact;
+    Deserializer compactDeserializer(compact.data(), compact.dataLength());
+    compactDeserializer.setFormat(Serialization::WireFormat::compact());
+    compactDeserializer.read(fromCompact);
+    EXPECT_EQ(*fromCompact.payload, *record.payload);
+}
+
+TEST(Deseralization, lazy_malformed)
+{
+    Serializer serializer;
+    serializer.write(static_cast<uint64_t>(100));
+    serializer.write(i);
+    Serialization::Lazy<int> tooLong;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    EXPECT_THROW(deserializer.read(tooLong), std::runtime_error);
+
+    // Length covers more bytes than the value uses
+    Serializer padded;
+    padded.write(static_cast<uint64_t>(sizeof(int) + 1));
+    padded.write(i);
+    padded.write('x');
+    Serialization::Lazy<int> trailing;
+    Deserializer paddedDeserializer(padded.data(), padded.dataLength());
+    paddedDeserializer.read(trailing);
+    EXPECT_THROW(trailing.get(), std::runtime_error);
+}
+
+TEST(Deseralization, compression_block_round_trip)
+{
+    std::vector<uint8_t> inputs[4];
+    inputs[1] = std::vector<uint8_t>(100000, 7);
+    for (int k = 0; k < 50000; ++k)
+        inputs[2].push_back(static_cast<uint8_t>(k * 2654435761u >> 24));
+    std::string text;
+    for (int k = 0; k < 2000; ++k)
+        text += "frame " + std::to_string(k % 37) + " abcabcabc ";
+    inputs[3].assign(text.begin(), text.end());
+
+    for (const auto &input : inputs)
+    {
+        std::vector<uint8_t> packed(Serialization::compressBound(input.size()));
+        size_t n = Serialization::compressBlock(input.data(), input.size(), packed.data());
+        ASSERT_LE(n, packed.size());
+        std::vector<uint8_t> output(input.size());
+        Serialization::decompressBlock(packed.data(), n, output.data(), output.size());
+        EXPECT_EQ(output, input);
+        if (input.size() > 1000 && &input != &inputs[2])
+        {
+            EXPECT_LT(n * 10, input.size());
+        }
+    }
+}
+
+TEST(Deseralization, compressed_value)
+{
+    std::vector<std::string> table;
+    for (int k = 0; k < 20000; ++k)
+        table.push_back("entry-" + std::to_string(k % 100));
+
+    Serialization::CompressionOptions options;
+    options.blockSize = 64 * 1024;
+    options.threads = 4;
+    Serializer serializer;
+    serializer.write(Serialization::compress(table, options));
+    serializer.write(i);
+    EXPECT_LT(serializer.dataLength() * 4, Serialization::serializedSize(table));
+
+    Serialization::Compressed<std::vector<std::string>> result;
+    result.setOptions(options);
+    int after = 0;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(result);
+    deserializer.read(after);
+    EXPECT_EQ(*result, table);
+    EXPECT_EQ(after, i);
+
+    // Below the threshold the value is stored as is
+    Serialization::Compressed<std::string> small(std::string("tiny"));
+    Serializer smallSerializer;
+    smallSerializer.write(small);
+    EXPECT_EQ(smallSerializer.dataLength(), 2 * sizeof(uint64_t) + Serialization::serializedSize(std::string("tiny")));
+    Serialization::Compressed<std::string> smallResult;
+    Deserializer smallDeserializer(smallSerializer.data(), smallSerializer.dataLength());
+    smallDeserializer.read(smallResult);
+    EXPECT_EQ(*smallResult, "tiny");
+
+    // Zero-copy pixels point into the decompressed bytes the field keeps
+    cv::Mat image(256, 256, CV_8UC3, cv::Scalar(9, 8, 7));
+    Serializer imageSerializer;
+    imageSerializer.write(Serialization::Compressed<cv::Mat>(image));
+    Serialization::Compressed<cv::Mat> imageResult;
+    {
+        Deserializer imageDeserializer(imageSerializer.data(), imageSerializer.dataLength());
+        imageDeserializer.setZeroCopy(true);
+        imageDeserializer.read(imageResult);
+    }
+    ASSERT_EQ(imageResult->total(), image.total());
+    EXPECT_EQ(imageResult->data[0], 9);
+    EXPECT_EQ(imageResult->data[image.total() * 3 - 1], 7);
+}
+
+TEST(Deseralization, compressed_corrupt)
+{
+    std::string text(200000, 'a');
+    Serializer serializer;
+    serializer.write(Serialization::compress(text));
+    std::vector<uint8_t> bytes(serializer.data(), serializer.data() + serializer.dataLength());
+
+    // Match offset before the start of the block
+    bytes[bytes.size() - 1] ^= 0xff;
+    bytes[3 * sizeof(uint64_t) + 3] = 0xff;
+    Serialization::Compressed<std::string> result;
+    Deserializer deserializer(bytes);
+    EXPECT_THROW(deserializer.read(result), std::runtime_error);
+
+    // Raw size far beyond what the blocks can expand to
+    std::vector<uint8_t> inflated(serializer.data(), serializer.data() + serializer.dataLength());
+    uint64_t huge = uint64_t(1) << 40;
+    std::memcpy(inflated.data(), &huge, sizeof(huge));
+    Deserializer inflatedDeserializer(inflated);
+    EXPECT_THROW(inflatedDeserializer.read(result), std::runtime_error);
+}
+
+TEST(Seralization, crc32c_known_values)
+{
+    const char *check = "123456789";
+    EXPECT_EQ(Serialization::crc32c(check, 9), 0xe3069283u);
+    EXPECT_EQ(Serialization::crc32c(check + 4, 5, Serialization::crc32c(check, 4)), 0xe3069283u);
+
+    // Accelerated kernels agree with the portable one at every alignment and length
+    std::vector<uint8_t> bytes(100003);
+    for (size_t k = 0; k < bytes.size(); ++k)
+        bytes[k] = static_cast<uint8_t>(k * 2654435761u >> 13);
+    for (size_t offset : {0, 1, 7})
+        for (size_t length : {0, 5, 64, 24576, 80000})
+            EXPECT_EQ(Serialization::crc32c(bytes.data() + offset, length),
+                      ~Serialization::crc::updatePortable(~0u, bytes.data() + offset, length));
+}
+
+TEST(Deseralization, checksum_trailer)
+{
+    std::vector<std::string> names(300, "checksummed");
+    std::vector<uint8_t> streamed;
+    Serialization::CallbackSink sink([&](const uint8_t *p, size_t n)
+                                     { streamed.insert(streamed.end(), p, p + n); },
+                                     64);
+    Serializer streaming(sink);
+    Serializer serializer;
+    uint32_t crcs[2];
+    int k = 0;
+    for (Serializer *s : {&serializer, &streaming})
+    {
+        s->write(i);
+        s->beginChecksum();
+        s->write(names);
+        s->write(tuple);
+        crcs[k++] = s->writeChecksum();
+        s->flush();
+    }
+    EXPECT_EQ(crcs[0], crcs[1]);
+    ASSERT_EQ(streamed.size(), serializer.dataLength());
+    EXPECT_EQ(std::memcmp(streamed.data(), serializer.data(), streamed.size()), 0);
+    EXPECT_TRUE(Serialization::hasValidChecksum(serializer.data() + sizeof(int), serializer.dataLength() - sizeof(int)));
+
+    int iDe = 0;
+    std::vector<std::string> namesDe;
+    std::tuple<std::string, int, double> tupleDe;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.read(iDe);
+    deserializer.beginChecksum();
+    deserializer.read(namesDe);
+    deserializer.read(tupleDe);
+    EXPECT_NO_THROW(deserializer.verifyChecksum());
+    EXPECT_EQ(namesDe, names);
+
+    // A flipped bit in a string decodes fine but fails the trailer
+    streamed[sizeof(int) + 2 * sizeof(uint64_t) + 3] ^= 0x10;
+    EXPECT_FALSE(Serialization::hasValidChecksum(streamed.data() + sizeof(int), streamed.size() - sizeof(int)));
+    Deserializer corrupt(streamed);
+    corrupt.read(iDe);
+    corrupt.beginChecksum();
+    corrupt.read(namesDe);
+    corrupt.read(tupleDe);
+    EXPECT_THROW(corrupt.verifyChecksum(), std::runtime_error);
+}
+
+#if defined(SERIALIZATION_HAS_PMR)
+TEST(Deseralization, pmr_arena_decode)
+{
+    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> table = {
+        {"first table entry key", {{"a long string that does not fit in place", 1}, {"b", 2}}},
+        {"second", {}}};
+    std::list<std::string> names = {"list entry that is long enough to allocate", "x"};
+    std::set<std::string> keys = {"set entry that is long enough to allocate", "y"};
+    Serializer serializer;
+    serializer.write(strVector);
+    serializer.write(table);
+    serializer.write(names);
+    serializer.write(keys);
+
+    std::pmr::monotonic_buffer_resource arena;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setMemoryResource(&arena);
+    auto strings = deserializer.make<std::pmr::vector<std::pmr::string>>();
+    auto tableDe = deserializer.make<std::pmr::unordered_map<std::pmr::string, std::pmr::vector<std::pair<std::pmr::string, int>>>>();
+    auto namesDe = deserializer.make<std::pmr::list<std::pmr::string>>();
+    auto keysDe = deserializer.make<std::pmr::set<std::pmr::string>>();
+
+    // Any allocation outside the arena throws
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    EXPECT_NO_THROW({
+        deserializer.read(strings);
+        deserializer.read(tableDe);
+        deserializer.read(namesDe);
+        deserializer.read(keysDe);
+    });
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(strings.get_allocator().resource(), &arena);
+    ASSERT_EQ(strings.size(), strVector.size());
+    EXPECT_EQ(strings[3], "D");
+    ASSERT_EQ(tableDe.size(), 2u);
+    const auto &entries = tableDe.at("first table entry key");
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].first, "a long string that does not fit in place");
+    EXPECT_EQ(entries[0].first.get_allocator().resource(), &arena);
+    EXPECT_EQ(namesDe.front(), names.front().c_str());
+    EXPECT_EQ(*keysDe.begin(), keys.begin()->c_str());
+
+    // pmr values write the same bytes as their std counterparts
+    Serializer pmrSerializer;
+    pmrSerializer.write(strings);
+    pmrSerializer.write(tableDe);
+    EXPECT_EQ(pmrSerializer.dataLength(), Serialization::serializedSize(strVector) + Serialization::serializedSize(table));
+}
+#endif
+
+// Move-only, no default constructor, built straight from the stream
+struct Handle
+{
+    int id;
+    std::unique_ptr<std::string> name;
+
+    Handle(int id, std::string name) : id(id), name(new std::string(std::move(name))) {}
+
+    void serialize(Serializer *s) const
+    {
+        s->write(id);
+        s->write(*name);
+    }
+
+    static Handle construct(Deserializer *d)
+    {
+        int id = d->read<int>();
+        return Handle(id, d->read<std::string>());
+    }
+};
+
+// Counts moves of decoded values
+struct Heavy
+{
+    static int moves;
+    std::vector<int> values;
+
+    Heavy() = default;
+    Heavy(Heavy &&other) noexcept : values(std::move(other.values)) { ++moves; }
+    Heavy &operator=(Heavy &&other) noexcept
+    {
+        values = std::move(other.values);
+        ++moves;
+        return *this;
+    }
+
+    void serialize(Serializer *s) const { s->write(values); }
+    void deserialize(Deserializer *d) { d->read(values); }
+};
+int Heavy::moves = 0;
+
+TEST(Deseralization, construct_in_place)
+{
+    std::vector<Handle> handles;
+    handles.emplace_back(1, "one");
+    handles.emplace_back(2, "two");
+    std::map<std::string, Handle> byName;
+    byName.emplace("first", Handle(3, "three"));
+    std::map<int, Heavy> heavyMap;
+    heavyMap[1].values = {1, 2, 3};
+    heavyMap[2].values = {4};
+    std::vector<Heavy> heavyVector(3);
+    heavyVector[2].values = {5, 6};
+
+    Serializer serializer;
+    serializer.write(handles);
+    serializer.write(byName);
+    serializer.write(heavyMap);
+    serializer.write(heavyVector);
+    serializer.write(std::make_pair(7, Handle(8, "eight")));
+    serializer.write(str);
+
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    auto handlesDe = deserializer.read<std::vector<Handle>>();
+    ASSERT_EQ(handlesDe.size(), 2u);
+    EXPECT_EQ(handlesDe[1].id, 2);
+    EXPECT_EQ(*handlesDe[1].name, "two");
+
+    std::map<std::string, Handle> byNameDe;
+    deserializer.read(byNameDe);
+    EXPECT_EQ(*byNameDe.at("first").name, "three");
+
+    Heavy::moves = 0;
+    auto heavyMapDe = deserializer.read<std::map<int, Heavy>>();
+    auto heavyVectorDe = deserializer.read<std::vector<Heavy>>();
+    EXPECT_EQ(Heavy::moves, 0);
+    EXPECT_EQ(heavyMapDe.at(1).values, heavyMap.at(1).values);
+    EXPECT_EQ(heavyVectorDe[2].values, heavyVector[2].values);
+
+    auto pairDe = deserializer.read<std::pair<int, Handle>>();
+    EXPECT_EQ(pairDe.first, 7);
+    EXPECT_EQ(*pairDe.second.name, "eight");
+    EXPECT_EQ(deserializer.read<std::string>(), str);
+}
+
+#if defined(SERIALIZATION_HAS_PMR)
+// Counts allocations that reach the upstream resource
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(Deseralization, reuse_decode_allocates_nothing)
+{
+    using Table = std::unordered_map<std::string, std::vector<std::pair<std::string, int>>>;
+    Table first = {{"a key long enough to allocate", {{"an entry long enough to allocate", 1}}},
+                   {"another key long enough to allocate", {{"x", 2}, {"y", 3}}}};
+    Table second = {{"a different key long enough to allocate", {{"entry two long enough to allocate", 4}}},
+                    {"yet another key long enough to allocate", {{"z", 5}, {"w", 6}}}};
+    std::list<std::string> names = {"list entry long enough to allocate", "short"};
+    std::set<std::string> keys = {"set entry long enough to allocate", "k"};
+
+    std::vector<std::vector<uint8_t>> messages;
+    for (const Table *table : {&first, &second, &first, &second})
+    {
+        Serializer serializer;
+        serializer.write(*table);
+        serializer.write(names);
+        serializer.write(keys);
+        messages.push_back(serializer.release());
+    }
+
+    CountingResource counting;
+    std::pmr::unordered_map<std::pmr::string, std::pmr::vector<std::pair<std::pmr::string, int>>> table(&counting);
+    std::pmr::list<std::pmr::string> namesDe(&counting);
+    std::pmr::set<std::pmr::string> keysDe(&counting);
+    for (size_t m = 0; m < messages.size(); ++m)
+    {
+        Deserializer deserializer(messages[m]);
+        deserializer.setReuse(true);
+        size_t before = counting.allocations;
+        deserializer.read(table);
+        deserializer.read(namesDe);
+        deserializer.read(keysDe);
+        // Warmed up once every string has seen its longest value
+        if (m > 1)
+        {
+            EXPECT_EQ(counting.allocations, before);
+        }
+    }
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.at("yet another key long enough to allocate")[1].first, "w");
+    EXPECT_EQ(namesDe.back(), "short");
+    EXPECT_EQ(keysDe.size(), 2u);
+
+    // Fewer and more elements than last time
+    std::vector<std::string> strings = {"one", "two", "three"};
+    std::vector<std::string> reused = {"a", "b", "c", "d", "e"};
+    std::set<std::string> set = {"p", "q"};
+    std::set<std::string> reusedSet = {"only"};
+    Serializer serializer;
+    serializer.write(strings);
+    serializer.write(set);
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setReuse(true);
+    deserializer.read(reused);
+    deserializer.read(reusedSet);
+    EXPECT_EQ(reused, strings);
+    EXPECT_EQ(reusedSet, set);
+}
+#endif
+
+// Hands out the input a few bytes at a time
+class TrickleSource : public Serialization::Source
+{
+public:
+    TrickleSource(const uint8_t *p, size_t n, size_t step) : p(p), left(n), step(step) {}
+
+    size_t read(uint8_t *out, size_t n) override
+    {
+        n = std::min({n, left, step});
+        std::memcpy(out, p, n);
+        p += n;
+        left -= n;
+        return n;
+    }
+
+private:
+    const uint8_t *p;
+    size_t left;
+    size_t step;
+};
+
+TEST(Deseralization, duplicate_keys_keep_first)
+{
+    std::multimap<int, std::string> pairs = {{1, "first"}, {1, "second"}, {2, "other"}};
+    Serializer serializer;
+    serializer.write(pairs);
+    serializer.write(pairs);
+    serializer.write(i);
+
+    std::map<int, std::string> map;
+    std::unordered_map<int, std::string> hashed = {{1, "stale"}, {3, "stale"}};
+    int after = 0;
+    Deserializer deserializer(serializer.data(), serializer.dataLength());
+    deserializer.setReuse(true);
+    deserializer.read(map);
+    deserializer.read(hashed);
+    deserializer.read(after);
+    EXPECT_EQ(map, (std::map<int, std::string>{{1, "first"}, {2, "other"}}));
+    EXPECT_EQ(hashed, (std::unordered_map<int, std::string>{{1, "first"}, {2, "other"}}));
+    EXPECT_EQ(after, i);
+
+    Deserializer fresh(serializer.data(), serializer.dataLength());
+    EXPECT_EQ((fresh.read<std::map<int, std::string>>()), (std::map<int, std::string>{{1, "first"}, {2, "other"}}));
+}
+
+TEST(Deseralization, streaming_source)
+{
+    std::string big(5000, 's');
+    std::vector<double> samples(3000, 0.25);
+    std::vector<int32_t> varints = { 1, -300, 70000 };
+    cv::Mat mat(40, 40, CV_16UC1, cv::Scalar(513));
+    RecordV2 record;
+    record.id = 9;
+    record.name = "streamed";
+    record.samples.assign(100, 1.5);
+    LazyRecord lazy;
+    lazy.id = 3;
+    lazy.payload = std::vector<std::string>{ "x", "y" };
+    Serialization::WireFormat swapped;
+    swapped.byteOrder = Serialization::hostIsLittleEndian() ? Serialization::ByteOrder::Big : Serialization::ByteOrder::Little;
+    swapped.integers = Serialization::IntegerEncoding::Varint;
+    Serialization::CompressionOptions options;
+    options.threshold = 0;
+    options.blockSize = 1024;
+    options.threads = 1;
+
+    for (const Serialization::WireFormat &format : { Serialization::WireFormat(), swapped })
+    {
+        Serializer serializer;
+        serializer.setFormat(format);
+        serializer.write(i);
+        serializer.beginChecksum();
+        serializer.write(big);
+        serializer.write(strVector);
+        serializer.write(samples);
+        serializer.write(varints);
+        serializer.write(mat);
+        serializer.write(record);
+        serializer.write(lazy);
+        serializer.writeCompressed(reinterpret_cast<const uint8_t *>(big.data()), big.size(), options);
+        serializer.writeChecksum();
+
+        TrickleSource source(serializer.data(), serializer.dataLength(), 7);
+        Deserializer deserializer(source, 64);
+        deserializer.setFormat(format);
+        deserializer.setZeroCopy(true);
+        EXPECT_EQ(deserializer.read<int>(), i);
+        deserializer.beginChecksum();
+        EXPECT_EQ(deserializer.read<std::string>(), big);
+        EXPECT_EQ(deserializer.read<std::vector<std::string>>(), strVector);
+        EXPECT_EQ(deserializer.read<std::vector<double>>(), samples);
+        EXPECT_EQ(deserializer.read<std::vector<int32_t>>(), varints);
+        cv::Mat matDe;
+        deserializer.read(matDe);
+        EXPECT_EQ(std::memcmp(matDe.data, mat.data, mat.total() * mat.elemSize()), 0);
+        RecordV2 recordDe = deserializer.read<RecordV2>();
+        EXPECT_EQ(recordDe.name, record.name);
+        EXPECT_EQ(recordDe.samples, record.samples);
+        LazyRecord lazyDe = deserializer.read<LazyRecord>();
+        Deserializer inflated = deserializer.readCompressed(1);
+        EXPECT_NO_THROW(deserializer.verifyChecksum());
+        EXPECT_EQ(*lazyDe.payload, *lazy.payload);
+        ASSERT_EQ(inflated.remaining(), big.size());
+        EXPECT_EQ(std::memcmp(inflated.readRaw(big.size()), big.data(), big.size()), 0);
+    }
+}
+
+TEST(Deseralization, streaming_source_limits)
+{
+    std::vector<float> floats(10000, 3.0f);
+    Serializer serializer;
+    serializer.write(floats);
+    serializer.write(str);
+
+    std::istringstream is(std::string(reinterpret_cast<const char *>(serializer.data()), serializer.dataLength()));
+    Serialization::IStreamSource source(is);
+    Deserializer deserializer(source, 256);
+    EXPECT_EQ(deserializer.read<std::vector<float>>(), floats);
+    std::string_view view;
+    EXPECT_THROW(deserializer.read(view), std::runtime_error);
+
+    // A truncated stream and a corrupt length fail without reading past the input
+    TrickleSource truncated(serializer.data(), serializer.dataLength() / 2, 100);
+    Deserializer partial(truncated, 256);
+    std::vector<float> floatsDe;
+    EXPECT_THROW(partial.read(floatsDe), std::runtime_error);
+    std::vector<uint8_t> corrupt(sizeof(uint64_t) + 16, 0xff);
+    TrickleSource corruptSource(corrupt.data(), corrupt.size(), 100);
+    Deserializer bogus(corruptSource, 256);
+    EXPECT_THROW(bogus.read(floatsDe), std::runtime_error);
+
+    // A Mat header announcing gigabytes is not trusted with an allocation
+    Serializer matHeader;
+    matHeader.write(1 << 16);
+    matHeader.write(1 << 16);
+    matHeader.write(static_cast<int>(CV_8UC3));
+    matHeader.write(static_cast<size_t>(1 << 16) * (1 << 16) * 3);
+    matHeader.write(str);
+    TrickleSource matSource(matHeader.data(), matHeader.dataLength(), 100);
+    Deserializer matDeserializer(matSource, 256);
+    cv::Mat mat;
+    EXPECT_THROW(matDeserializer.read(mat), std::runtime_error);
+    EXPECT_TRUE(mat.empty());
+
+    // So is a header over the configured limit, for pixels and decompressed frames
+    Serialization::CompressionOptions options;
+    options.threshold = 0;
+    options.blockSize = 1024;
+    std::string text(4000, 't');
+    Serializer limited;
+    limited.write(cv::Mat(40, 40, CV_16UC1, cv::Scalar(7)));
+    limited.writeCompressed(reinterpret_cast<const uint8_t *>(text.data()), text.size(), options);
+    TrickleSource tightSource(limited.data(), limited.dataLength(), 100);
+    Deserializer tight(tightSource, 256);
+    tight.setMaxAllocation(3199);
+    EXPECT_THROW(tight.read(mat), std::runtime_error);
+    TrickleSource frameSource(limited.data(), limited.dataLength(), 100);
+    Deserializer frame(frameSource, 256);
+    frame.setMaxAllocation(3200);
+    EXPECT_EQ(frame.read<cv::Mat>().total(), 1600u);
+    EXPECT_THROW(frame.readCompressed(1), std::runtime_error);
+    TrickleSource looseSource(limited.data(), limited.dataLength(), 100);
+    Deserializer loose(looseSource, 256);
+    loose.setMaxAllocation(text.size());
+    loose.read(mat);
+    EXPECT_EQ(loose.readCompressed(1).remaining(), text.size());
+
+    // A window grown for readRaw() goes back to its size on the next refill
+    struct RecordingSource : TrickleSource
+    {
+        using TrickleSource::TrickleSource;
+        size_t largest = 0;
+        size_t read(uint8_t *out, size_t n) override
+        {
+            largest = std::max(largest, n);
+            return TrickleSource::read(out, n);
+        }
+    };
+    Serializer raw;
+    raw.write(text);
+    raw.write(strVector);
+    RecordingSource recording(raw.data(), raw.dataLength(), 100000);
+    Deserializer grown(recording, 256);
+    uint64_t len = grown.readLength();
+    EXPECT_EQ(std::memcmp(grown.readRaw(len), text.data(), text.size()), 0);
+    recording.largest = 0;
+    EXPECT_EQ(grown.read<std::vector<std::string>>(), strVector);
+    EXPECT_GT(recording.largest, 0u);
+    EXPECT_LE(recording.largest, 256u);
+
+#ifndef _WIN32
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fwrite(serializer.data(), 1, serializer.dataLength(), file), serializer.dataLength());
+    fflush(file);
+    rewind(file);
+    Serialization::FdSource fdSource(fileno(file));
+    Deserializer fromFd(fdSource, 256);
+    EXPECT_EQ(fromFd.read<std::vector<float>>(), floats);
+    EXPECT_EQ(fromFd.read<std::string>(), str);
+    fclose(file);
+#endif
+}
+
+TEST(Deseralization, frame_decoder_resumes)
+{
+    std::vector<double> samples(5000, 0.75);
+    Serialization::WireFormat compact;
+    compact.lengths = Serialization::LengthEncoding::Varint;
+    compact.integers = Serialization::IntegerEncoding::Varint;
+
+    for (const Serialization::WireFormat &format : { Serialization::WireFormat(), compact })
+    {
+        Serializer serializer;
+        serializer.setFormat(format);
+        serializer.writeFrame(strVector);
+        serializer.writeFrame(std::string());
+        serializer.writeFrame(samples);
+        serializer.writeFrame(tuple);
+
+        for (size_t step : { size_t(1), size_t(13), serializer.dataLength() })
+        {
+            Serialization::FrameDecoder decoder(format);
+            EXPECT_THROW(decoder.message(), std::runtime_error);
+            std::vector<Deserializer> frames;
+            const uint8_t *p = serializer.data();
+            size_t left = serializer.dataLength();
+            while (left > 0)
+            {
+                size_t chunk = std::min(step, left);
+                for (size_t used = 0; used < chunk;)
+                {
+                    used += decoder.feed(p + used, chunk - used);
+                    if (decoder.ready())
+                        frames.push_back(decoder.message());
+                }
+                // Partway through the large frame its length is known and progress is kept
+                if (step == 13 && frames.size() == 2 && decoder.state() == Serialization::FrameDecoder::State::Payload)
+                {
+                    EXPECT_EQ(decoder.expected(), Serialization::serializedSize(samples, format));
+                    EXPECT_GT(decoder.received(), 0u);
+                }
+                p += chunk;
+                left -= chunk;
+            }
+            EXPECT_EQ(decoder.state(), Serialization::FrameDecoder::State::Length);
+            ASSERT_EQ(frames.size(), 4u);
+            EXPECT_EQ(frames[0].read<std::vector<std::string>>(), strVector);
+            EXPECT_EQ(frames[1].read<std::string>(), "");
+            EXPECT_EQ(frames[1].remaining(), 0u);
+            EXPECT_EQ(frames[2].read<std::vector<double>>(), samples);
+            EXPECT_EQ((frames[3].read<std::tuple<std::string, int, double>>()), tuple);
+        }
+    }
+
+    // Oversized lengths are rejected before the payload arrives
+    Serializer serializer;
+    serializer.writeFrame(samples);
+    Serialization::FrameDecoder decoder(Serialization::WireFormat(), 1024);
+    EXPECT_THROW(decoder.feed(serializer.data(), serializer.dataLength()), std::runtime_error);
+    uint64_t huge = uint64_t(1) << 30;
+    Serialization::FrameDecoder defaults;
+    EXPECT_THROW(defaults.feed(reinterpret_cast<const uint8_t *>(&huge), sizeof(huge)), std::runtime_error);
+
+    // Types with write<> specializations, in a swapped byte order
+    cv::Mat image(8, 8, CV_16UC1, cv::Scalar(513));
+    cv::Rect rect(1, 2, 3, 4);
+    Serialization::WireFormat big;
+    big.byteOrder = Serialization::ByteOrder::Big;
+    Serializer matSerializer;
+    matSerializer.setFormat(big);
+    matSerializer.writeFrame(image);
+    matSerializer.writeFrame(rect);
+    EXPECT_EQ(matSerializer.dataLength(), 2 * sizeof(uint64_t) + Serialization::serializedSize(image, big) +
+                                              Serialization::serializedSize(rect, big));
+    Serialization::FrameDecoder matDecoder(big);
+    size_t used = matDecoder.feed(matSerializer.data(), matSerializer.dataLength());
+    ASSERT_TRUE(matDecoder.ready());
+    cv::Mat imageDe = matDecoder.message().read<cv::Mat>();
+    EXPECT_EQ(std::memcmp(imageDe.data, image.data, image.total() * image.elemSize()), 0);
+    matDecoder.feed(matSerializer.data() + used, matSerializer.dataLength() - used);
+    ASSERT_TRUE(matDecoder.ready());
+    EXPECT_EQ(matDecoder.message().read<cv::Rect>(), rect);
+
+    // A large frame arriving in pieces
+    std::vector<uint8_t> large(1 << 20, 7);
+    Serializer largeSerializer;
+    largeSerializer.writeFrame(large);
+    Serialization::FrameDecoder largeDecoder;
+    for (size_t used = 0; used < largeSerializer.dataLength();)
+        used += largeDecoder.feed(largeSerializer.data() + used, std::min<size_t>(4096, largeSerializer.dataLength() - used));
+    ASSERT_TRUE(largeDecoder.ready());
+    EXPECT_EQ(largeDecoder.message().read<std::vector<uint8_t>>(), large);
+}
+
+#ifndef _WIN32
+TEST(Deseralization, mapped_archive)
+{
+    std::string path = testing::TempDir() + "serializer_archive_test.bin";
+    std::vector<float> floats(4096, 1.25f);
+    cv::Mat mat(32, 32, CV_8UC3, cv::Scalar(1, 2, 3));
+    {
+        Serialization::ArchiveWriter writer(path, Serialization::WireFormat::compact());
+        writer.write(tuple);
+        writer.write(floats);
+        writer.write(mat);
+        Serializer &kept = writer.serializer();
+        writer.close();
+        // Writes after close() fail instead of reaching a reused descriptor
+        EXPECT_THROW(writer.write(i), std::runtime_error);
+        EXPECT_THROW(writer.serializer(), std::runtime_error);
+        kept.write(i);
+        EXPECT_THROW(kept.flush(), std::runtime_error);
+    }
+    EXPECT_THROW(Serialization::ArchiveWriter(testing::TempDir() + "missing/archive.bin"), std::runtime_error);
+
+    Serialization::MatView view;
+    {
+        Serialization::MappedArchive archive(path, Serialization::MappedArchive::Access::Sequential);
+        EXPECT_EQ(archive.format().lengths, Serialization::LengthEncoding::Varint);
+        EXPECT_NE(archive.format().byteOrder, Serialization::ByteOrder::Native);
+        Deserializer reader = archive.reader();
+        EXPECT_EQ((reader.read<std::tuple<std::string, int, double>>()), tuple);
+        Serialization::Span<float> span;
+        reader.read(span);
+        ASSERT_EQ(span.size(), floats.size());
+        EXPECT_GE(span.bytes(), archive.data());
+        EXPECT_LT(span.bytes(), archive.data() + archive.size());
+        EXPECT_EQ(span[100], 1.25f);
+        archive.prefetch(0, archive.size());
+        reader.read(view);
+    }
+    // The view keeps the mapping alive
+    ASSERT_TRUE(view.owner != nullptr);
+    EXPECT_EQ(std::memcmp(view.mat.data, mat.data, mat.total() * mat.elemSize()), 0);
+
+    FILE *file = fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    fputs("not an archive, just text", file);
+    fclose(file);
+    EXPECT_THROW(Serialization::MappedArchive{path}, std::runtime_error);
+    remove(path.c_str());
+}
+#endif
+
+TEST(Seralization, parallel_write_matches_sequential)
+{
+    std::vector<std::string> names;
+    std::map<int, std::vector<std::string>> groups;
+    for (int k = 0; k < 5000; ++k)
+    {
+        names.push_back("name " + std::to_string(k * 7));
+        groups[k] = { std::to_string(k), "x" };
+    }
+    std::list<RecordV1> records(3000);
+    int id = 0;
+    for (RecordV1 &record : records)
+    {
+        record.id = id++;
+        record.name = std::to_string(id);
+    }
+
+    Serialization::ParallelOptions options;
+    options.threshold = 100;
+    options.chunkSize = 64;
+    options.threads = 4;
+    for (const Serialization::WireFormat &format : { Serialization::WireFormat(), Serialization::WireFormat::compact() })
+    {
+        Serializer sequential;
+        sequential.setFormat(format);
+        Serializer parallel;
+        parallel.setFormat(format);
+        parallel.setParallel(true, options);
+        std::vector<uint8_t> streamed;
+        Serialization::CallbackSink sink([&](const uint8_t *p, size_t n)
+                                         { streamed.insert(streamed.end(), p, p + n); });
+        Serializer parallelStreaming(sink);
+        parallelStreaming.setFormat(format);
+        parallelStreaming.setParallel(true, options);
+        uint32_t crcs[3];
+        int k = 0;
+        for (Serializer *s : { &sequential, &parallel, &parallelStreaming })
+        {
+            s->beginChecksum();
+            s->write(names);
+            s->write(groups);
+            s->write(records);
+            crcs[k++] = s->writeChecksum();
+            s->flush();
+        }
+        ASSERT_EQ(parallel.dataLength(), sequential.dataLength());
+        EXPECT_EQ(std::memcmp(parallel.data(), sequential.data(), sequential.dataLength()), 0);
+        ASSERT_EQ(streamed.size(), sequential.dataLength());
+        EXPECT_EQ(std::memcmp(streamed.data(), sequential.data(), sequential.dataLength()), 0);
+        EXPECT_EQ(crcs[0], crcs[1]);
+        EXPECT_EQ(crcs[0], crcs[2]);
+    }
+
+    // Only containers encoded in parallel skip the top-level size pre-pass
+    struct RecordingSink : Serialization::VectorSink
+    {
+        std::vector<size_t> reserved;
+        void reserve(size_t n) override
+        {
+            reserved.push_back(n);
+            VectorSink::reserve(n);
+        }
+    } recording;
+    Serializer presized(recording);
+    presized.setParallel(true, options);
+    presized.write(records.front());
+    presized.write(names);
+    ASSERT_EQ(recording.reserved.size(), 2u);
+    EXPECT_EQ(recording.reserved[0], Serialization::serializedSize(records.front()));
+    EXPECT_EQ(recording.reserved[1], Serialization::serializedSize(names) - sizeof(uint64_t));
+}
+
+TEST(Deseralization, chunk_index_parallel_read)
+{
+    std::vector<std::string> names;
+    std::list<RecordV1> records;
+    std::set<int> ids;
+    std::map<int, std::string> labels;
+    std::unordered_map<std::string, std::vector<int>> groups;
+    for (int k = 0; k < 1000; ++k)
+    {
+        names.push_back("name " + std::to_string(k * 7));
+        RecordV1 record;
+        record.id = k;
+        record.name = std::to_string(k);
+        records.push_back(record);
+        ids.insert(k * 3);
+        labels[k] = std::to_string(k);
+        groups[std::to_string(k)] = { k, -k };
+    }
+    std::vector<int> small = { 1, 2, 3 };
+
+    for (Serialization::WireFormat format : { Serialization::WireFormat(), Serialization::WireFormat::compact() })
+    {
+        format.chunkIndexThreshold = 100;
+        format.chunkElements = 64;
+        Serializer s;
+        s.setFormat(format);
+        s.write(names);
+        s.write(records);
+        s.write(ids);
+        s.write(labels);
+        s.write(groups);
+        s.write(small);
+        EXPECT_EQ(Serialization::serializedSize(std::make_tuple(names, records, ids, labels, groups, small), format),
+                  s.dataLength());
+
+        // A parallel writer with its own chunk size produces the same index
+        Serialization::ParallelOptions options;
+        options.threshold = 100;
+        options.chunkSize = 10;
+        options.threads = 4;
+        Serializer parallelWriter;
+        parallelWriter.setFormat(format);
+        parallelWriter.setParallel(true, options);
+        parallelWriter.write(names);
+        parallelWriter.write(records);
+        ASSERT_LE(parallelWriter.dataLength(), s.dataLength());
+        EXPECT_EQ(std::memcmp(parallelWriter.data(), s.data(), parallelWriter.dataLength()), 0);
+
+        for (bool parallel : { true, false })
+        {
+            Deserializer d(s.data(), s.dataLength());
+            d.setFormat(format);
+            d.setParallel(parallel, options);
+            EXPECT_EQ(d.read<std::vector<std::string>>(), names);
+            std::list<RecordV1> readRecords = d.read<std::list<RecordV1>>();
+            ASSERT_EQ(readRecords.size(), records.size());
+            EXPECT_EQ(readRecords.back().name, records.back().name);
+            EXPECT_EQ(d.read<std::set<int>>(), ids);
+            EXPECT_EQ((d.read<std::map<int, std::string>>()), labels);
+            EXPECT_EQ((d.read<std::unordered_map<std::string, std::vector<int>>>()), groups);
+            EXPECT_EQ(d.read<std::vector<int>>(), small);
+        }
+
+        // Reuse mode and pmr containers fall back to a sequential read
+        Deserializer reused(s.data(), s.dataLength());
+        reused.setFormat(format);
+        reused.setParallel(true, options);
+        reused.setReuse(true);
+        std::vector<std::string> readNames(5, "old");
+        reused.read(readNames);
+        EXPECT_EQ(readNames, names);
+#if defined(SERIALIZATION_HAS_PMR)
+        std::pmr::monotonic_buffer_resource arena;
+        Deserializer pmr(s.data(), s.dataLength());
+        pmr.setFormat(format);
+        pmr.setParallel(true, options);
+        pmr.setMemoryResource(&arena);
+        auto pmrNames = pmr.make<std::pmr::vector<std::pmr::string>>();
+        pmr.read(pmrNames);
+        ASSERT_EQ(pmrNames.size(), names.size());
+        EXPECT_EQ(std::string(pmrNames.back()), names.back());
+#endif
+    }
+
+    // Chunk sizes that do not match the elements are rejected
+    Serialization::WireFormat format;
+    format.chunkIndexThreshold = 100;
+    format.chunkElements = 64;
+    Serializer s;
+    s.setFormat(format);
+    s.write(names);
+    std::vector<uint8_t> corrupt(s.data(), s.data() + s.dataLength());
+    corrupt[2 * sizeof(uint64_t)] += 1; // first chunk size
+    Serialization::ParallelOptions options;
+    options.threads = 4;
+    Deserializer d(corrupt.data(), corrupt.size());
+    d.setFormat(format);
+    d.setParallel(true, options);
+    EXPECT_THROW(d.read<std::vector<std::string>>(), std::runtime_error);
+}
+
+TEST(Deseralization, chunk_index_duplicate_keys)
+{
+    // Duplicates within a chunk and across chunk boundaries
+    std::multimap<int, int> pairs;
+    for (int k = 0; k < 500; ++k)
+    {
+        pairs.emplace(k / 3, k);
+        pairs.emplace(0, k);
+    }
+    Serialization::WireFormat format;
+    format.chunkIndexThreshold = 100;
+    format.chunkElements = 64;
+    Serializer serializer;
+    serializer.setFormat(format);
+    serializer.write(pairs);
+    serializer.write(pairs);
+
+    Serialization::ParallelOptions options;
+    options.threads = 4;
+    std::map<int, int> results[2];
+    std::unordered_map<int, int> hashed[2];
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        Deserializer deserializer(serializer.data(), serializer.dataLength());
+        deserializer.setFormat(format);
+        deserializer.setParallel(parallel != 0, options);
+        deserializer.read(results[parallel]);
+        deserializer.read(hashed[parallel]);
+    }
+    EXPECT_EQ(results[0], results[1]);
+    EXPECT_EQ(hashed[0], hashed[1]);
+    EXPECT_EQ(results[1].at(0), 0);
+    EXPECT_EQ(hashed[1].at(1), 3);
+}